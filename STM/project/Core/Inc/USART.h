@@ -7,11 +7,28 @@ extern "C" {
 
 #include "main.h"
 #include "stm32h7xx_hal_uart.h"
+#include <stdbool.h>
 
 extern UART_HandleTypeDef huart1;
+extern DMA_HandleTypeDef hdma_usart1_tx;
 
 void MX_USART1_UART_Init(void);
 
+/* 运行时修改波特率，发送进行中返回 HAL_BUSY */
+HAL_StatusTypeDef USART1_SetBaudRate(uint32_t baud);
+
+/* 写入 DMA 发送环后立即返回；空间不足时整段丢弃并返回 HAL_BUSY */
+HAL_StatusTypeDef USART1_Write(const uint8_t *buf, uint32_t len);
+
+/* printf 经 DMA 发送环异步输出；环满时丢弃的字节数 */
+uint32_t USART1_TxDropped(void);
+
+/* 等待发送环中的数据全部发出，最长 USART_TX_FLUSH_MS；DMA 启动失败时在等待中重试 */
+void USART1_TxFlush(void);
+
+/* 非阻塞读取一个接收字节（轮询），无数据返回 false */
+bool USART1_ReadByte(uint8_t *ch);
+
 #ifdef __cplusplus
 }
 #endif
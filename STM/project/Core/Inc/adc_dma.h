@@ -10,13 +10,20 @@ extern "C"
 #include "stm32h7xx_hal_adc.h"
 #include "stm32h7xx_hal_dma.h"
 #include "stm32h7xx_hal_tim.h"
+#include "config.h"
 
     extern ADC_HandleTypeDef hadc1;
+#if ADC_DUAL_SIMULT_ENABLE
+    extern ADC_HandleTypeDef hadc2;
+#endif
     extern DMA_HandleTypeDef hdma_adc1;
     extern TIM_HandleTypeDef htim2;
 
     void MX_ADC1_Init(void);
-    HAL_StatusTypeDef ADC_DMA_Start(uint16_t *buffer, uint32_t length);
+    HAL_StatusTypeDef ADC_DMA_Start(uint16_t *buf0, uint16_t *buf1, uint32_t length);
+    HAL_StatusTypeDef ADC_DMA_SetNextBuffer(uint16_t *buffer);
+    HAL_StatusTypeDef ADC_DMA_Stop(void);
+    HAL_StatusTypeDef ADC_DMA_SetSampleRate(uint32_t fs_hz);
 
 #ifdef __cplusplus
 }
@@ -13,17 +13,55 @@ extern "C"
 #endif
 
 #include "main.h"
+#include "gcc_phat.h"
 #include <stdbool.h>
 
+    /**
+     * @brief 采样档位
+     */
+    typedef struct
+    {
+        uint32_t fs_hz;   /* 采样率 (Hz) */
+        uint32_t frame_n; /* 帧长度（采样点数） */
+        uint32_t fft_l;   /* FFT 长度 */
+    } app_doa_profile_t;
+
     /**
      * @brief 初始化 DOA 系统
      * @retval HAL_StatusTypeDef
      */
     HAL_StatusTypeDef app_doa_init(void);
 
+    /**
+     * @brief 切换采样档位（无需复位）
+     * @param index 档位编号 (< app_doa_profile_count())
+     * @retval HAL_StatusTypeDef
+     * @note 停止采集，重配 TIM2、FFT 实例、窗函数和搜索范围后重新启动，
+     *       待处理帧被丢弃
+     */
+    HAL_StatusTypeDef app_doa_set_profile(uint32_t index);
+
+    /**
+     * @brief 获取档位参数
+     * @param index 档位编号
+     * @retval 档位参数，编号越界时返回 NULL
+     */
+    const app_doa_profile_t *app_doa_get_profile(uint32_t index);
+
+    /**
+     * @brief 获取当前档位编号
+     */
+    uint32_t app_doa_current_profile(void);
+
+    /**
+     * @brief 获取档位数量
+     */
+    uint32_t app_doa_profile_count(void);
+
     /**
      * @brief 处理一帧音频数据
-     * @note 执行 GCC-PHAT 算法和可信度判决
+     * @note 推入一个 hop 后对滑动窗执行 GCC-PHAT 算法和可信度判决，
+     *       估计速率为 FS / (frame_n / FRAME_HOP_DIV)
      */
     void app_doa_process_frame(void);
 
@@ -33,6 +71,14 @@ extern "C"
      */
     bool app_doa_frame_ready(void);
 
+    /**
+     * @brief 读取最近一次估计结果
+     * @param result 输出 GCC-PHAT 结果
+     * @param theta_smooth 输出平滑后的角度，可为 NULL
+     * @retval true: 自上次读取以来有新的估计; false: 无
+     */
+    bool app_doa_get_result(gcc_phat_result_t *result, float *theta_smooth);
+
     /**
      * @brief 打印调试信息
      */
@@ -2,7 +2,9 @@
  * @file audio_frame.h
  * @brief DMA 音频帧管理模块
  *
- * 将 DMA 连续采集的数据组织为算法处理所需的帧
+ * 将 DMA 连续采集的数据组织为算法处理所需的帧。
+ * DMA 按帧写入 AUDIO_RING_SLOTS 个槽位组成的环形缓冲区，
+ * 主循环可通过 acquire/release 零拷贝地访问已完成的帧。
  */
 #ifndef __AUDIO_FRAME_H__
 #define __AUDIO_FRAME_H__
@@ -17,11 +19,41 @@ extern "C"
 #include <stdbool.h>
 
     /**
-     * @brief 初始化音频帧模块并启动 DMA 采集
+     * @brief 采集统计信息
+     */
+    typedef struct
+    {
+        uint32_t frames_captured; /* DMA 写满的帧总数（含丢弃） */
+        uint32_t frames_dropped;  /* 环形缓冲区已满而丢弃的帧数 */
+        uint32_t pending;         /* 当前待处理帧数 */
+        uint32_t max_pending;     /* 待处理帧数历史最大值 */
+    } audio_frame_stats_t;
+
+    /**
+     * @brief 初始化音频帧模块并以默认帧长度 FRAME_N 启动 DMA 采集
      * @retval HAL_StatusTypeDef
      */
     HAL_StatusTypeDef audio_frame_init(void);
 
+    /**
+     * @brief 以指定帧长度启动 DMA 采集
+     * @param frame_n 每帧采样对数 (<= FRAME_N_MAX)
+     * @retval HAL_StatusTypeDef
+     */
+    HAL_StatusTypeDef audio_frame_start(uint32_t frame_n);
+
+    /**
+     * @brief 停止 DMA 采集并丢弃待处理帧
+     * @retval HAL_StatusTypeDef
+     */
+    HAL_StatusTypeDef audio_frame_stop(void);
+
+    /**
+     * @brief 获取当前帧长度
+     * @retval 每帧采样对数
+     */
+    uint32_t audio_frame_length(void);
+
     /**
      * @brief 检查是否有新帧可用
      * @retval true: 有帧可用; false: 无帧
@@ -29,19 +61,50 @@ extern "C"
     bool audio_frame_available(void);
 
     /**
-     * @brief 获取当前帧数据（转换为浮点）
-     * @param x1 麦克风1数据输出缓冲区 (长度 FRAME_N)
-     * @param x2 麦克风2数据输出缓冲区 (长度 FRAME_N)
+     * @brief 获取最早的待处理帧（零拷贝）
+     * @param seq 输出帧序号，可为 NULL；序号不连续说明中间有帧被丢弃
+     * @retval 交错格式的帧数据 (长度 2*audio_frame_length())，无帧时返回 NULL
+     * @note 返回的数据在 audio_frame_release() 之前不会被 DMA 覆盖
+     */
+    const uint16_t *audio_frame_acquire(uint32_t *seq);
+
+    /**
+     * @brief audio_frame_acquire() 取得的帧写满（DMA 传输完成）时的 HAL_GetTick()
+     * @retval 毫秒节拍；无待处理帧时无意义
+     * @note 在传输完成中断里记录，不受主循环处理或串口发送积压的影响
+     */
+    uint32_t audio_frame_tick(void);
+
+    /**
+     * @brief 释放 audio_frame_acquire() 取得的帧，槽位归还 DMA
+     */
+    void audio_frame_release(void);
+
+    /**
+     * @brief 获取当前帧数据（转换为浮点）并释放该帧
+     * @param x1 麦克风1数据输出缓冲区 (长度 audio_frame_length())
+     * @param x2 麦克风2数据输出缓冲区 (长度 audio_frame_length())
      */
     void audio_frame_get(float *x1, float *x2);
 
     /**
-     * @brief DMA 半传输完成回调（由中断调用）
+     * @brief 双通道去交错并转换为归一化浮点 [-1, 1)
+     * @param src 交错格式的 ADC 数据 (长度 2*n，需 4 字节对齐)
+     * @param x1 麦克风1输出 (长度 n)
+     * @param x2 麦克风2输出 (长度 n)
+     * @param n 采样对数（4 的倍数时走展开路径）
+     * @note 可直接作用于 audio_frame_acquire() 返回的 DMA 槽位
+     */
+    void audio_frame_to_float(const uint16_t *src, float *x1, float *x2, uint32_t n);
+
+    /**
+     * @brief 读取采集统计信息
+     * @param stats 输出统计结构体
      */
-    void audio_frame_half_cplt_callback(void);
+    void audio_frame_get_stats(audio_frame_stats_t *stats);
 
     /**
-     * @brief DMA 全传输完成回调（由中断调用）
+     * @brief DMA 帧传输完成回调（由中断调用）
      */
     void audio_frame_cplt_callback(void);
 
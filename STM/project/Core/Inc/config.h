@@ -13,22 +13,80 @@ extern "C"
 #endif
 
 /* ========== 采样与帧参数 ========== */
+/* 上电默认档位，运行时可由 app_doa_set_profile() 切换（档位表见 app_doa.c） */
 #define FS_HZ 48000U  /* 采样率 48 kHz */
 #define FRAME_N 1024U /* 帧长度（采样点数） */
 #define FFT_L 2048U   /* FFT 长度（零填充后） */
 
+/* 运行时档位上限，决定静态缓冲区大小 */
+#define FS_HZ_MAX 96000U  /* 最高采样率 */
+#define FRAME_N_MAX 2048U /* 最大帧长度 */
+#define FFT_L_MAX 4096U   /* 最大 FFT 长度（CMSIS RFFT 上限） */
+
+/* 滑动窗分析：每 FRAME_N/FRAME_HOP_DIV 个新采样输出一次估计，FFT 分辨率不变 */
+#define FRAME_HOP_DIV 2U /* 1: 不重叠; 2: 50% 重叠; 4: 75% 重叠; 8: 87.5% 重叠 */
+
+/* ========== ADC 采集模式 ========== */
+#define ADC_DUAL_SIMULT_ENABLE 1U /* 1: ADC1+ADC2 规则同步采样（零通道间偏移）; 0: ADC1 顺序扫描两通道 */
+
+/* 硬件过采样：TIM2 以 FS_HZ*ADC_OVS_RATIO 触发，ADC 累加 ADC_OVS_RATIO 次后右移 ADC_OVS_SHIFT 位输出 */
+#define ADC_OVERSAMPLING_ENABLE 0U /* 1: 启用硬件过采样（需双 ADC 同步模式） */
+#define ADC_OVS_RATIO 4U           /* 过采样倍数 (1 ~ 1024) */
+#define ADC_OVS_SHIFT 2U           /* 累加结果右移位数 (0 ~ 11)，需满足 ADC_OVS_RATIO <= 2^ADC_OVS_SHIFT */
+
+/* ========== 采集环形缓冲区 ========== */
+#define AUDIO_RING_SLOTS 4U /* DMA 帧槽位数（>=3，其中 2 个始终由 DMA 占用） */
+
+/* ========== 调试串口 ========== */
+#define USART_TX_RING_SIZE 1024U /* printf 发送环大小（字节，2 的幂），满时丢弃并计数 */
+#define USART_TX_FLUSH_MS 200U    /* USART1_TxFlush() 最长等待，满环 @115200 约 90 ms */
+
+/* 二进制遥测：每次估计输出一条 COBS 帧 (telemetry.c)，主机用 Tools/telemetry_decode.py 解码 */
+#define TELEMETRY_ENABLE 1U      /* 1: 遥测帧取代文本调试打印; 0: 每 10 帧 printf 一行 */
+#define TELEMETRY_BAUD 921600U   /* 遥测模式波特率 */
+
 /* ========== 物理参数 ========== */
 #define MIC_DIST_M 0.12f   /* 麦克风间距 (m) */
 #define SOUND_SPEED 343.0f /* 声速 (m/s) */
 
 /* ========== 算法参数 ========== */
-#define ALPHA_SMOOTH 0.2f /* 一阶低通滤波系数 */
-#define EPS_PHAT 1e-12f   /* PHAT 加权防除零 */
+#define ALPHA_SMOOTH 0.2f     /* 一阶低通滤波系数 */
+#define ANGLE_LUT_DIV 8U      /* 滞后 -> 角度查找表每采样点的分段数 */
+#define ANGLE_LUT_MAX_LAG 40U /* 查找表容量（最大滞后，采样点），需 >= MAX_LAG_SAMPLES_MAX，超出时搜索范围被截断 */
+#define EPS_PHAT 1e-12f       /* PHAT 加权防除零 */
+
+/* GCC-PHAT 有效频带：带外频点（低频隆隆声、麦克风带宽以上的 ADC 噪声）置零，
+ * 不被 PHAT 归一化放大到单位幅度；运行时可由 gcc_phat_set_band() 修改 */
+#define GCC_BAND_LO_HZ 200U  /* 下限 (Hz)，0 表示包含直流 */
+#define GCC_BAND_HI_HZ 8000U /* 上限 (Hz)，超过 fs/2 时取到 Nyquist */
+
+/* 互功率谱跨帧递归平均（PHAT 加权前）：S = lambda*S + (1-lambda)*G，弱而持续的声源逐帧积累；
+ * 越大越稳但跟踪越慢，时间常数约 hop/(1-lambda) 个采样；运行时可由 gcc_phat_set_spec_avg() 修改 */
+#define GCC_SPEC_AVG_LAMBDA 0.5f /* 遗忘因子 [0, 1)，0 表示每帧独立 */
+
+/* 亚采样插值方式，运行时可由 gcc_phat_set_interp() 修改 */
+#define GCC_INTERP_MODE 0U /* 0: 三点抛物线; 1: 三点高斯; 2: 加窗 sinc 细化; 3: 相位斜率拟合 */
 
 /* ========== 可信度判决阈值 ========== */
 #define PEAK_MIN 0.15f /* 峰值高度阈值 */
 #define RATIO_MIN 1.5f /* 主峰/次峰比阈值 */
 
+/* ========== 实时性监测 ========== */
+/* 每个 hop 须在下一 hop 到达前处理完；平滑负载持续过高时按策略降级（见 deadline.h） */
+#define DEADLINE_SHED_POLICY 0U       /* 0: 仅监测; 1: 跳帧; 2: 缩短 FFT（去零填充）; 3: 插值退回抛物线 */
+#define DEADLINE_SHED_LOAD_PCT 85U    /* 负载高于此值持续 DEADLINE_SHED_HOLD 个 hop 后降级 */
+#define DEADLINE_RESTORE_LOAD_PCT 60U /* 负载低于此值持续 DEADLINE_RESTORE_HOLD 个 hop 后恢复 */
+#define DEADLINE_SHED_HOLD 8U         /* 约 85 ms @ 默认档位 */
+#define DEADLINE_RESTORE_HOLD 256U    /* 约 2.7 s，降级后负载必然下降，恢复需更长确认 */
+
+/* ========== 调试选项 ========== */
+#define DSP_BENCH_ENABLE 0U /* 1: 启动时运行内核周期基准测试 (dsp_bench.c) */
+#define PROFILE_ENABLE 0U   /* 1: DOA 流水线分段计时 (profile.c)，串口发送 'p' 输出统计、'r' 清零 */
+
+/* 原始 PCM 采集：经 USART1 DMA 输出带帧头的交错 ADC 帧，主机用 Tools/pcm_capture_to_wav.py 转存 WAV */
+#define PCM_CAPTURE_ENABLE 0U     /* 1: 上电进入采集模式（不运行 DOA） */
+#define PCM_CAPTURE_BAUD 4000000U /* 采集模式波特率，需 > FS_HZ*40（4 字节/采样对，10 位/字节） */
+
 /* ========== 舵机参数 ========== */
 #define SERVO_MIN_US 500U     /* 最小脉宽 (us) */
 #define SERVO_MAX_US 2500U    /* 最大脉宽 (us) */
@@ -38,11 +96,74 @@ extern "C"
 /* 最大时间延迟 = d / c */
 #define MAX_DELAY_S (MIC_DIST_M / SOUND_SPEED)
 
-/* 最大延迟采样点数 = floor(d/c * Fs) ≈ 17 */
-#define MAX_LAG_SAMPLES ((uint32_t)((MIC_DIST_M / SOUND_SPEED) * FS_HZ) + 1U)
+/* 给定采样率下的最大延迟采样点数 = floor(d/c * Fs) + 1 */
+#define MAX_LAG_FOR_FS(fs) ((uint32_t)((MIC_DIST_M / SOUND_SPEED) * (float)(fs)) + 1U)
+
+/* 默认档位最大延迟采样点数 ≈ 17 */
+#define MAX_LAG_SAMPLES MAX_LAG_FOR_FS(FS_HZ)
+
+/* 所有档位中的最大延迟采样点数 */
+#define MAX_LAG_SAMPLES_MAX MAX_LAG_FOR_FS(FS_HZ_MAX)
+
+/* 单帧 DMA 数据长度（双通道交错，FRAME_N 个采样对） */
+#define DMA_FRAME_SIZE (FRAME_N * 2U)
 
-/* DMA 缓冲区大小（双通道交错，FRAME_N 个采样点） */
-#define DMA_BUFFER_SIZE (FRAME_N * 2U)
+/* DMA 槽位大小，按最大帧长度分配 */
+#define DMA_FRAME_SIZE_MAX (FRAME_N_MAX * 2U)
+
+/* DMA 环形缓冲区总大小 */
+#define DMA_BUFFER_SIZE (DMA_FRAME_SIZE_MAX * AUDIO_RING_SLOTS)
+
+/* 每个输出采样对应的 ADC 触发次数 */
+#if ADC_OVERSAMPLING_ENABLE
+#define ADC_TRIGGERS_PER_SAMPLE ADC_OVS_RATIO
+#else
+#define ADC_TRIGGERS_PER_SAMPLE 1U
+#endif
+
+#if (FRAME_N > FRAME_N_MAX) || (FFT_L > FFT_L_MAX) || (FS_HZ > FS_HZ_MAX)
+#error "default FS_HZ/FRAME_N/FFT_L exceed the runtime profile limits"
+#endif
+
+#if ADC_OVERSAMPLING_ENABLE && !ADC_DUAL_SIMULT_ENABLE
+#error "ADC oversampling requires ADC_DUAL_SIMULT_ENABLE (scan mode would oversample the channels one after another)"
+#endif
+
+#if ADC_OVERSAMPLING_ENABLE && ((ADC_OVS_RATIO < 1U) || (ADC_OVS_RATIO > 1024U) || (ADC_OVS_SHIFT > 11U) || (ADC_OVS_RATIO > (1UL << ADC_OVS_SHIFT)))
+#error "ADC_OVS_RATIO/ADC_OVS_SHIFT out of range: the shifted sum must fit in 16 bits"
+#endif
+
+#if (FRAME_HOP_DIV != 1U) && (FRAME_HOP_DIV != 2U) && (FRAME_HOP_DIV != 4U) && (FRAME_HOP_DIV != 8U)
+#error "FRAME_HOP_DIV must be 1, 2, 4 or 8"
+#endif
+
+#if PCM_CAPTURE_ENABLE && (PCM_CAPTURE_BAUD <= FS_HZ * 40U)
+#error "PCM_CAPTURE_BAUD too low to stream FS_HZ stereo 16-bit samples"
+#endif
+
+#if (USART_TX_RING_SIZE == 0U) || ((USART_TX_RING_SIZE & (USART_TX_RING_SIZE - 1U)) != 0U) || (USART_TX_RING_SIZE > 65535U)
+#error "USART_TX_RING_SIZE must be a power of 2 below 64K"
+#endif
+
+#if GCC_INTERP_MODE > 3U
+#error "GCC_INTERP_MODE must be 0..3"
+#endif
+
+#if GCC_BAND_LO_HZ > GCC_BAND_HI_HZ
+#error "GCC_BAND_LO_HZ must not exceed GCC_BAND_HI_HZ"
+#endif
+
+#if DEADLINE_SHED_POLICY > 3U
+#error "DEADLINE_SHED_POLICY must be 0..3"
+#endif
+
+#if DEADLINE_RESTORE_LOAD_PCT >= DEADLINE_SHED_LOAD_PCT
+#error "DEADLINE_RESTORE_LOAD_PCT must be below DEADLINE_SHED_LOAD_PCT"
+#endif
+
+#if (AUDIO_RING_SLOTS < 3U) || (AUDIO_RING_SLOTS > 32U)
+#error "AUDIO_RING_SLOTS must be in [3, 32]"
+#endif
 
 #ifdef __cplusplus
 }
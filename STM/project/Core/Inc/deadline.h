@@ -0,0 +1,90 @@
+/**
+ * @file deadline.h
+ * @brief 帧处理截止时间监测与过载降级判决
+ *
+ * DMA 每交付一个 hop 记录一次到达时刻（DWT 周期计数），主循环处理完该 hop 时
+ * 检查下一 hop 是否已经到达：已到达即为一次超时（处理跟不上采集，积压开始增长）。
+ * 同时按 hop 周期统计平滑 CPU 负载，负载持续高于 DEADLINE_SHED_LOAD_PCT 时
+ * 进入降级状态，持续低于 DEADLINE_RESTORE_LOAD_PCT 时恢复，
+ * 具体降级动作由调用方按 DEADLINE_SHED_POLICY 执行。
+ */
+#ifndef __DEADLINE_H__
+#define __DEADLINE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+#include <stdbool.h>
+
+/* DEADLINE_SHED_POLICY 取值 */
+#define DEADLINE_SHED_NONE 0U   /* 仅监测，不降级 */
+#define DEADLINE_SHED_SKIP 1U   /* 跳帧：隔一个 hop 估计一次，积压时直接追赶 */
+#define DEADLINE_SHED_FFT 2U    /* 缩短 FFT：去掉零填充，FFT 长度减半 */
+#define DEADLINE_SHED_INTERP 3U /* 插值退回抛物线 */
+
+    /**
+     * @brief 降级状态变化
+     */
+    typedef enum
+    {
+        DEADLINE_EVT_NONE = 0, /* 状态不变 */
+        DEADLINE_EVT_SHED,     /* 进入降级 */
+        DEADLINE_EVT_RESTORE   /* 恢复正常 */
+    } deadline_event_t;
+
+    /**
+     * @brief 监测统计
+     */
+    typedef struct
+    {
+        uint32_t hops;         /* 已完成处理的 hop 数 */
+        uint32_t misses;       /* 处理完成时下一 hop 已到达的次数 */
+        uint32_t max_late;     /* 最大超时周期数（相对下一 hop 到达时刻） */
+        uint32_t load_pct;     /* 平滑 CPU 负载 (%) */
+        uint32_t load_max_pct; /* 单个 hop 的最大负载 (%) */
+        uint32_t shed_events;  /* 进入降级的次数 */
+        bool shedding;         /* 当前是否处于降级状态 */
+    } deadline_stats_t;
+
+    /**
+     * @brief 按采样率与步长设置 hop 周期，并清空统计与降级状态
+     * @param fs_hz 采样率
+     * @param hop 每个 DMA 帧的采样对数
+     * @note 需在 DWT 周期计数器使能后、audio_frame_start() 之前调用
+     */
+    void deadline_configure(uint32_t fs_hz, uint32_t hop);
+
+    /**
+     * @brief 记录一个 hop 的到达时刻（由 DMA 传输完成中断调用）
+     * @param seq 帧序号
+     */
+    void deadline_dma_stamp(uint32_t seq);
+
+    /**
+     * @brief 一个 hop 处理完成
+     * @param seq 该 hop 的帧序号
+     * @param t_begin 开始处理时的 DWT->CYCCNT
+     * @retval 降级状态变化，由调用方执行对应的降级或恢复动作
+     */
+    deadline_event_t deadline_end(uint32_t seq, uint32_t t_begin);
+
+    /**
+     * @brief 当前是否处于降级状态
+     */
+    bool deadline_shedding(void);
+
+    /**
+     * @brief 读取监测统计
+     * @param stats 输出统计结构体
+     */
+    void deadline_get_stats(deadline_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DEADLINE_H__ */
@@ -0,0 +1,29 @@
+/**
+ * @file dsp_bench.h
+ * @brief 信号处理内核周期基准测试
+ *
+ * 基于 DWT CYCCNT 对比优化内核与参考实现的耗时和数值误差，
+ * 结果通过串口打印。由 config.h 中的 DSP_BENCH_ENABLE 控制是否在启动时运行。
+ */
+#ifndef __DSP_BENCH_H__
+#define __DSP_BENCH_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+
+    /**
+     * @brief 运行全部基准测试并打印结果
+     * @retval HAL_OK: 带容限的检查项全部通过; HAL_ERROR: 有检查项失败
+     * @note 会占用 CPU 数百毫秒，应在启动 DMA 采集前调用
+     */
+    HAL_StatusTypeDef dsp_bench_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_BENCH_H__ */
@@ -0,0 +1,65 @@
+/**
+ * @file frame_window.h
+ * @brief 滑动窗帧拼接模块
+ *
+ * DMA 每次交付 hop 个采样对，本模块将其转换为浮点后写入长度为
+ * frame_n 的历史环，每推入一个 hop 即形成一个新的分析窗（重叠 frame_n - hop）。
+ * 每个采样只转换写入一次，分析窗以“环 + 起始下标”的形式交给 GCC-PHAT。
+ */
+#ifndef __FRAME_WINDOW_H__
+#define __FRAME_WINDOW_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+#include <stdbool.h>
+
+    /**
+     * @brief 设置窗长与步长并清空历史
+     * @param frame_n 分析窗长度 (<= FRAME_N_MAX)
+     * @param hop 步长，需整除 frame_n
+     * @retval HAL_OK: 成功; HAL_ERROR: 参数非法
+     * @note DMA 帧长度需同步设为 hop（见 audio_frame_start()）
+     */
+    HAL_StatusTypeDef frame_window_configure(uint32_t frame_n, uint32_t hop);
+
+    /**
+     * @brief 清空历史，重新开始填充
+     */
+    void frame_window_reset(void);
+
+    /**
+     * @brief 从 audio_frame 取一个 hop 写入历史环
+     * @retval true: 分析窗已填满，可调用 frame_window_get(); false: 无新数据或仍在填充
+     * @note 检测到丢帧（序号不连续）时丢弃历史，重新填充一个完整窗
+     */
+    bool frame_window_push(void);
+
+    /**
+     * @brief 获取当前分析窗
+     * @param x1 输出麦克风1历史环首地址 (长度 frame_n)
+     * @param x2 输出麦克风2历史环首地址 (长度 frame_n)
+     * @retval 最早采样在环中的下标，窗口按 [start, frame_n) + [0, start) 排列
+     */
+    uint32_t frame_window_get(const float **x1, const float **x2);
+
+    /**
+     * @brief 最近推入的 DMA 帧序号
+     */
+    uint32_t frame_window_seq(void);
+
+    /**
+     * @brief 当前步长
+     * @retval 每次估计之间的新采样数
+     */
+    uint32_t frame_window_hop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_WINDOW_H__ */
@@ -25,24 +25,208 @@ extern "C"
         float dt;        /* 时间差 (s) */
         float theta_deg; /* 角度 (度) */
         float peak;      /* 主峰值 */
-        float ratio;     /* 主峰/次峰比 */
+        float ratio;     /* 主峰/次峰比（次峰为主瓣之外的局部极大值） */
         bool valid;      /* 结果是否有效 */
     } gcc_phat_result_t;
 
+    /**
+     * @brief 亚采样插值方式（数值与 config.h 中 GCC_INTERP_MODE 对应）
+     */
+    typedef enum
+    {
+        GCC_PHAT_INTERP_PARABOLIC = 0,  /* 三点抛物线 */
+        GCC_PHAT_INTERP_GAUSSIAN = 1,   /* 三点高斯（对数抛物线） */
+        GCC_PHAT_INTERP_SINC = 2,       /* 加窗 sinc 重建后细化 */
+        GCC_PHAT_INTERP_PHASE_SLOPE = 3 /* 互功率谱相位斜率加权最小二乘 */
+    } gcc_phat_interp_t;
+
+    /* gcc_phat_find_peaks() 最多返回的峰数 */
+#define GCC_PHAT_PEAKS_MAX 4U
+
+    /**
+     * @brief GCC 输出中的一个峰（TDOA 候选）
+     */
+    typedef struct
+    {
+        float lag_sub;   /* 亚采样精度延迟（采样点） */
+        float dt;        /* 时间差 (s) */
+        float theta_deg; /* 角度 (度) */
+        float height;    /* 峰高 |r(lag)| */
+    } gcc_phat_peak_t;
+
+    /**
+     * @brief 由互功率谱求 GCC 滞后窗口的方式
+     */
+    typedef enum
+    {
+        GCC_PHAT_LAG_IFFT = 0, /* 完整 N 点实数 IFFT */
+        GCC_PHAT_LAG_DFT = 1,  /* 只对 ±max_lag 直接 DFT */
+        GCC_PHAT_LAG_AUTO = 2  /* 仅用于 gcc_phat_set_lag_eval()：取消强制，恢复实测选择 */
+    } gcc_phat_lag_eval_t;
+
     /**
      * @brief 初始化 GCC-PHAT 模块
-     * @note 初始化 FFT 实例和汉宁窗
+     * @note 以默认档位 FS_HZ / FRAME_N / FFT_L 初始化 FFT 实例和汉宁窗
      */
     void gcc_phat_init(void);
 
+    /**
+     * @brief 切换采样率、帧长度和 FFT 长度
+     * @param fs_hz 采样率 (<= FS_HZ_MAX)
+     * @param frame_n 帧长度 (<= FRAME_N_MAX 且 <= fft_l)
+     * @param fft_l FFT 长度 (32 ~ FFT_L_MAX 的 2 的幂)
+     * @retval HAL_OK: 成功; HAL_ERROR: 参数非法，保持原配置
+     * @note 重新初始化 FFT 实例、汉宁窗和峰值搜索范围；DWT 周期计数器已使能且未经
+     *       gcc_phat_set_lag_eval() 强制指定时，实测两种滞后窗口求值方式，直接 DFT 明显
+     *       更快才选用，否则用完整 IFFT。fft_l 以下直到 frame_n 的各缩短长度也一并实测，
+     *       供 gcc_phat_switch_fft_len() 直接取用
+     */
+    HAL_StatusTypeDef gcc_phat_configure(uint32_t fs_hz, uint32_t frame_n, uint32_t fft_l);
+
+    /**
+     * @brief 运行中缩短或恢复 FFT 长度（过载降级用）
+     * @param fft_l 新长度：gcc_phat_configure() 的 fft_l 除以 2 的幂，不短于帧长度和 32
+     * @retval HAL_OK: 成功; HAL_ERROR: 长度不在上述范围，保持原长度
+     * @note 不重建汉宁窗、余弦表和角度查找表，也不重新实测：求值方式取 gcc_phat_configure()
+     *       时缓存的结果；递归平均状态按频率重采样后保留，频点加权按新长度重新抽取
+     */
+    HAL_StatusTypeDef gcc_phat_switch_fft_len(uint32_t fft_l);
+
+    /**
+     * @brief 当前 FFT 长度（gcc_phat_switch_fft_len() 缩短后为缩短的长度）
+     */
+    uint32_t gcc_phat_get_fft_len(void);
+
+    /**
+     * @brief 强制指定滞后窗口求值方式（覆盖实测选择）
+     * @param mode 求值方式；GCC_PHAT_LAG_AUTO 取消强制并立即重新实测
+     * @note 强制指定后 gcc_phat_configure() / gcc_phat_set_band() / gcc_phat_set_geometry() /
+     *       gcc_phat_set_interp() 都不再改变求值方式
+     */
+    void gcc_phat_set_lag_eval(gcc_phat_lag_eval_t mode);
+
+    /**
+     * @brief 当前滞后窗口求值方式
+     */
+    gcc_phat_lag_eval_t gcc_phat_get_lag_eval(void);
+
+    /**
+     * @brief 修改阵列几何（麦克风间距、声速），重建搜索范围与角度查找表
+     * @param mic_dist_m 麦克风间距 (m)
+     * @param sound_speed 声速 (m/s)，可按温度修正
+     * @retval HAL_OK: 成功; HAL_ERROR: 参数非法，或最高采样率下最大滞后超过 ANGLE_LUT_MAX_LAG
+     */
+    HAL_StatusTypeDef gcc_phat_set_geometry(float mic_dist_m, float sound_speed);
+
+    /**
+     * @brief 滞后转换为到达角（查表 + 线性插值代替 asinf，端射方向 |theta| > 78 度时直接计算）
+     * @param lag 滞后（采样点，可为小数）
+     * @retval 角度 (度)，超出物理范围时为 ±90
+     */
+    float gcc_phat_lag_to_theta(float lag);
+
+    /**
+     * @brief 设置亚采样插值方式
+     * @param mode 插值方式
+     * @note 直接 DFT 求值时 sinc 方式需在峰值两侧多计算若干滞后，切换后重新实测选择逆变换方式
+     */
+    void gcc_phat_set_interp(gcc_phat_interp_t mode);
+
+    /**
+     * @brief 切换亚采样插值方式，不重新实测逆变换方式（过载降级用）
+     * @param mode 插值方式
+     * @note 沿用按原插值方式选定的求值方式，直接 DFT 的滞后窗口宽度仍随插值方式调整，结果不受影响
+     */
+    void gcc_phat_switch_interp(gcc_phat_interp_t mode);
+
+    /**
+     * @brief 当前亚采样插值方式
+     */
+    gcc_phat_interp_t gcc_phat_get_interp(void);
+
+    /**
+     * @brief 设置互功率谱递归平均的遗忘因子
+     * @param lambda 遗忘因子 [0, 1)，S = lambda * S + (1 - lambda) * G，0 表示不平均
+     * @retval HAL_OK: 成功; HAL_ERROR: 超出范围
+     * @note 平均在 PHAT 归一化之前进行，弱而持续的声源可跨帧积累；设置时清空平均状态
+     */
+    HAL_StatusTypeDef gcc_phat_set_spec_avg(float lambda);
+
+    /**
+     * @brief 清空互功率谱平均状态（声源突变或数据不连续时调用）
+     * @note gcc_phat_configure() / gcc_phat_set_band() 会自动清空；
+     *       gcc_phat_switch_fft_len() 按频率重采样保留
+     */
+    void gcc_phat_reset_spec_avg(void);
+
+    /**
+     * @brief 设置 GCC-PHAT 有效频带，带外频点不参与互功率谱与 PHAT 归一化
+     * @param lo_hz 下限 (Hz)，0 表示包含直流
+     * @param hi_hz 上限 (Hz)，>= fs/2 表示包含 Nyquist
+     * @retval HAL_OK: 成功; HAL_ERROR: lo_hz > hi_hz
+     * @note 频带以 Hz 保存，gcc_phat_configure() 切换档位后按新采样率重新换算；
+     *       频点加权随之复位为 1
+     */
+    HAL_StatusTypeDef gcc_phat_set_band(uint32_t lo_hz, uint32_t hi_hz);
+
+    /**
+     * @brief 当前有效频点范围
+     * @param k_lo 输出起始频点 (0 为直流)
+     * @param k_hi 输出结束频点 (含，fft_l/2 为 Nyquist)
+     */
+    void gcc_phat_get_band_bins(uint32_t *k_lo, uint32_t *k_hi);
+
+    /**
+     * @brief 设置带内频点加权，PHAT 归一化后乘以该系数
+     * @param weight 加权系数，weight[i] 对应频点 k_lo + i
+     * @param n 系数个数，需等于 k_hi - k_lo + 1
+     * @retval HAL_OK: 成功; HAL_ERROR: 个数与当前频带不符，或 FFT 已被 gcc_phat_switch_fft_len() 缩短
+     * @note 只有相对大小有意义：内部按总权重归一化，完全相干时峰值为 1；
+     *       gcc_phat_set_band() / gcc_phat_configure() 后需重新设置；
+     *       缩短 FFT 时按频率抽取，恢复后仍为原设置
+     */
+    HAL_StatusTypeDef gcc_phat_set_band_weights(const float *weight, uint32_t n);
+
     /**
      * @brief 执行 GCC-PHAT 时延估计
-     * @param x1 麦克风1数据 (长度 FRAME_N)
-     * @param x2 麦克风2数据 (长度 FRAME_N)
+     * @param x1 麦克风1数据 (长度为当前帧长度)
+     * @param x2 麦克风2数据 (长度为当前帧长度)
      * @param result 输出结果结构体
      */
     void gcc_phat_process(const float *x1, const float *x2, gcc_phat_result_t *result);
 
+    /**
+     * @brief 对环形缓冲区中的分析窗执行 GCC-PHAT
+     * @param x1 麦克风1历史环 (长度为当前帧长度)
+     * @param x2 麦克风2历史环 (长度为当前帧长度)
+     * @param start 最早采样在环中的下标 (< 当前帧长度)
+     * @param result 输出结果结构体
+     * @note 窗口按 [start, N) + [0, start) 的时间顺序处理，无需先拼接成连续帧
+     */
+    void gcc_phat_process_ring(const float *x1, const float *x2, uint32_t start, gcc_phat_result_t *result);
+
+    /**
+     * @brief 从最近一次 gcc_phat_process() 的 GCC 输出中提取前 k_max 个峰
+     * @param peaks 输出数组 (长度 >= k_max)，按峰高降序
+     * @param k_max 最多提取的峰数 (超过 GCC_PHAT_PEAKS_MAX 时按其截断)
+     * @retval 实际提取的峰数
+     * @note 只在物理约束范围 ±max_lag 内取局部极大值，并对同一主瓣做非极大值抑制，
+     *       用于多声源跟踪；结果不受 PEAK_MIN / RATIO_MIN 判决影响。每个峰都做亚采样插值，
+     *       gcc_phat_process_ring() 自身只插值通过判决的主峰
+     */
+    uint32_t gcc_phat_find_peaks(gcc_phat_peak_t *peaks, uint32_t k_max);
+
+    /**
+     * @brief 打包复数 FFT 正变换的精度检查（dsp_bench 用，与 GCC_PHAT_PACKED_FFT 的取值无关）
+     * @param x1 麦克风1数据 (长度为当前帧长度)
+     * @param x2 麦克风2数据 (长度为当前帧长度)
+     * @param work 工作区，至少 4 * 当前 FFT 长度个 float
+     * @retval 全部频点上 max |G_packed - G_rfft| / max |G_rfft|，G = X1 * conj(X2)，
+     *         G_rfft 由两路 arm_rfft_fast_f32 求得，G_packed 经打包复数 FFT 与共轭对称分离求得
+     * @note 不经过递归平均与 PHAT 加权，不改变模块状态
+     */
+    float gcc_phat_packed_fft_error(const float *x1, const float *x2, float *work);
+
 #ifdef __cplusplus
 }
 #endif
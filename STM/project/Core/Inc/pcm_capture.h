@@ -0,0 +1,61 @@
+/**
+ * @file pcm_capture.h
+ * @brief 原始 PCM 采集模块
+ *
+ * 将 DMA 槽位中的交错 ADC 帧原样经 USART1 DMA 发出，每帧前附帧头。
+ * 线上格式（小端）: [pcm_capture_header_t][frame_n 个采样对 (CH0, CH1) uint16 偏移码]
+ * 主机端解析见 Tools/pcm_capture_to_wav.py。
+ */
+#ifndef __PCM_CAPTURE_H__
+#define __PCM_CAPTURE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+
+/* 帧头同步字，线上字节序为 'P' 'C' 'M' 'F' */
+#define PCM_CAPTURE_MAGIC 0x464D4350UL
+
+/* 帧头格式版本 */
+#define PCM_CAPTURE_VERSION 1U
+
+    /**
+     * @brief 采集帧头 (20 字节)
+     */
+    typedef struct __attribute__((packed))
+    {
+        uint32_t magic;   /* PCM_CAPTURE_MAGIC */
+        uint8_t version;  /* PCM_CAPTURE_VERSION */
+        uint8_t channels; /* 通道数，固定为 2 */
+        uint16_t frame_n; /* 本帧采样对数 */
+        uint32_t seq;     /* 帧序号，不连续说明中间有帧被丢弃 */
+        uint32_t tick_ms; /* 本帧 DMA 写满时的 HAL_GetTick() */
+        uint32_t fs_hz;   /* 采样率 */
+    } pcm_capture_header_t;
+
+    /**
+     * @brief 切换串口到 PCM_CAPTURE_BAUD 并以默认档位启动采集
+     * @retval HAL_StatusTypeDef
+     * @note 采集模式下帧由本模块消费，不可同时运行 DOA；之后不应再调用 printf
+     */
+    HAL_StatusTypeDef pcm_capture_init(void);
+
+    /**
+     * @brief 主循环轮询：串口空闲时发出下一帧，发送完成后释放槽位
+     */
+    void pcm_capture_poll(void);
+
+    /**
+     * @brief 串口 DMA 发送完成回调（由 USART.c 中的 HAL 回调调用）
+     */
+    void pcm_capture_tx_cplt_callback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PCM_CAPTURE_H__ */
@@ -0,0 +1,90 @@
+/**
+ * @file profile.h
+ * @brief 基于 DWT 周期计数器的分段耗时统计
+ *
+ * 每个命名分段记录调用次数、最小/平均/最大周期数，以及按 1/4 倍频程分桶的直方图
+ * （用于估计 p99）。PROFILE_ENABLE 为 0 时 PROFILE_BEGIN/PROFILE_END 展开为空，
+ * 热路径不增加任何开销。
+ * 统计结果经 printf 输出，主循环收到串口命令 'p' 时打印、'r' 时清零。
+ */
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+
+    /**
+     * @brief 分段编号
+     * @note 分段可以嵌套，各自统计包含子分段在内的耗时；PROF_PREPROCESS..PROF_INTERP 互不重叠，
+     *       都位于 PROF_GCC_TOTAL 之内，可直接相加与之对照
+     */
+    typedef enum
+    {
+        PROF_FRAME_GET = 0, /* frame_window_push: 取 hop + 转浮点写入历史环 */
+        PROF_PREPROCESS,    /* 去直流 + 加窗 + 清零填充段 */
+        PROF_FFT,           /* 正向 FFT（打包模式一次 CFFT，否则两次 RFFT） */
+        PROF_CROSS_PHAT,    /* 分离 + 互功率谱 + 递归平均 + PHAT 加权 */
+        PROF_LAG_EVAL,      /* IFFT 或滞后窗口直接 DFT */
+        PROF_PEAK,          /* 主峰与次峰的整数滞后搜索 */
+        PROF_INTERP,        /* 主峰亚采样插值 + 角度换算，每帧至多一次（仅通过判决的帧） */
+        PROF_GCC_TOTAL,     /* gcc_phat_process_ring 整体 */
+        PROF_OUTPUT,        /* 平滑、舵机目标与遥测输出 */
+        PROF_FRAME_TOTAL,   /* app_doa_process_frame 一次完整估计 */
+        PROF_SCOPE_COUNT
+    } profile_scope_t;
+
+#if PROFILE_ENABLE
+/* 分段计时，BEGIN/END 须在同一作用域内成对使用 */
+#define PROFILE_BEGIN(id) uint32_t prof_t0_##id = DWT->CYCCNT
+#define PROFILE_END(id) profile_record((id), DWT->CYCCNT - prof_t0_##id)
+#else
+#define PROFILE_BEGIN(id) ((void)0)
+#define PROFILE_END(id) ((void)0)
+#endif
+
+    /**
+     * @brief 使能 DWT 周期计数器并清空统计
+     */
+    void profile_init(void);
+
+    /**
+     * @brief 清空统计
+     */
+    void profile_reset(void);
+
+    /**
+     * @brief 设置每次估计的周期预算（hop 周期），用于输出余量
+     * @param fs_hz 采样率
+     * @param hop 每次估计之间的新采样数
+     */
+    void profile_set_budget(uint32_t fs_hz, uint32_t hop);
+
+    /**
+     * @brief 记录一次分段耗时
+     * @param id 分段编号
+     * @param cycles 周期数
+     */
+    void profile_record(profile_scope_t id, uint32_t cycles);
+
+    /**
+     * @brief 经 printf 输出所有分段统计与预算余量
+     * @note 逐行等待发送完成，避免超出发送环；遥测模式下末尾补 0x00 分隔符，
+     *       解码端把这段文本当作一帧丢弃，不影响后续遥测帧
+     */
+    void profile_dump(void);
+
+    /**
+     * @brief 轮询串口命令：'p' 输出统计，'r' 清空统计
+     */
+    void profile_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILE_H__ */
@@ -15,6 +15,8 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void DMA1_Stream0_IRQHandler(void);
+void DMA1_Stream1_IRQHandler(void);
+void USART1_IRQHandler(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,72 @@
+/**
+ * @file telemetry.h
+ * @brief DOA 二进制遥测模块
+ *
+ * 每次估计输出一条定长记录，代替 printf 浮点格式化。
+ * 线上格式: COBS(record || CRC16) 0x00
+ * CRC16 为 CRC-16/CCITT-FALSE (多项式 0x1021，初值 0xFFFF)，按小端附在记录之后，
+ * 覆盖整条记录。0x00 为帧分隔符，接收端可在任意位置重新同步。
+ * 主机端解码见 Tools/telemetry_decode.py。
+ */
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+#include "gcc_phat.h"
+
+/* 记录格式版本，字段变化时递增 */
+#define TELEMETRY_VERSION 1U
+
+/* 记录标志位 */
+#define TELEMETRY_FLAG_VALID 0x01U /* gcc_phat_result_t.valid */
+
+    /**
+     * @brief 遥测记录 (38 字节，小端)
+     */
+    typedef struct __attribute__((packed))
+    {
+        uint8_t version;       /* TELEMETRY_VERSION */
+        uint8_t flags;         /* TELEMETRY_FLAG_* */
+        uint32_t seq;          /* 最新 DMA 帧序号 */
+        float lag_sub;         /* 亚采样精度延迟（采样点） */
+        float dt;              /* 时间差 (s) */
+        float theta_deg;       /* 本次角度 (度) */
+        float peak;            /* 主峰值 */
+        float ratio;           /* 主峰/次峰比 */
+        float theta_smooth;    /* 平滑后角度 (度) */
+        uint32_t cycles_gcc;   /* GCC-PHAT 处理周期数 */
+        uint32_t cycles_total; /* 整次估计（含取帧）周期数 */
+    } telemetry_record_t;
+
+    /**
+     * @brief 切换串口到 TELEMETRY_BAUD
+     * @retval HAL_StatusTypeDef
+     * @note 之后串口上只有遥测帧，不应再调用 printf
+     */
+    HAL_StatusTypeDef telemetry_init(void);
+
+    /**
+     * @brief 编码并发送一条记录（非阻塞，发送环满时整帧丢弃）
+     * @param rec 待发送记录，version 字段由本函数填写
+     */
+    void telemetry_send(telemetry_record_t *rec);
+
+    /**
+     * @brief CRC-16/CCITT-FALSE
+     * @param data 数据
+     * @param len 字节数
+     * @retval CRC 值
+     */
+    uint16_t telemetry_crc16(const uint8_t *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEMETRY_H__ */
@@ -1,8 +1,19 @@
 
 #include "USART.h"
+#include "config.h"
+#include "pcm_capture.h"
 #include <stdio.h>
+#include <string.h>
 
 UART_HandleTypeDef huart1;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+/* printf 发送环：_write 写入（生产者），DMA 发送完成中断推进读指针（消费者） */
+__attribute__((section(".dma_d2"), aligned(32))) static uint8_t tx_ring[USART_TX_RING_SIZE];
+static volatile uint32_t tx_head = 0;  /* 写指针（自由计数），仅 _write 修改 */
+static volatile uint32_t tx_tail = 0;  /* 读指针（自由计数），仅发送完成时修改 */
+static volatile uint32_t tx_busy = 0;  /* 正在由 DMA 发送的字节数，0 表示空闲 */
+static volatile uint32_t tx_dropped = 0;
 
 void MX_USART1_UART_Init(void)
 {
@@ -41,17 +52,207 @@ void MX_USART1_UART_Init(void)
         Error_Handler();
     }
 
+    /* TX DMA: DMA1_Stream1，源缓冲区需位于 DMA1 可访问的 D2 SRAM (.dma_d2) */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    hdma_usart1_tx.Instance = DMA1_Stream1;
+    hdma_usart1_tx.Init.Request = DMA_REQUEST_USART1_TX;
+    hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart1_tx.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_usart1_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&huart1, hdmatx, hdma_usart1_tx);
+
+    /* 优先级低于 ADC DMA，采集不受串口发送影响 */
+    HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+
     /* 禁用 stdout 缓冲，便于直接 printf 输出 */
     setvbuf(stdout, NULL, _IONBF, 0);
 }
 
+HAL_StatusTypeDef USART1_SetBaudRate(uint32_t baud)
+{
+    if (huart1.gState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    /* HAL_UART_Init 会先关闭 UE 再写 BRR，DMA 关联保持不变 */
+    huart1.Init.BaudRate = baud;
+    return HAL_UART_Init(&huart1);
+}
+
+/**
+ * @brief 若 DMA 空闲，发出环中下一段连续数据
+ * @note 在中断或关中断的上下文中调用
+ */
+static void tx_kick(void)
+{
+    uint32_t tail = tx_tail;
+    uint32_t pending = tx_head - tail;
+    uint32_t offset = tail & (USART_TX_RING_SIZE - 1U);
+    uint32_t chunk;
+
+    if (tx_busy != 0U || pending == 0U)
+    {
+        return;
+    }
+
+    /* 只发到环末尾，回绕部分在下次完成中断中发送 */
+    chunk = USART_TX_RING_SIZE - offset;
+    if (chunk > pending)
+    {
+        chunk = pending;
+    }
+
+    if (HAL_UART_Transmit_DMA(&huart1, &tx_ring[offset], (uint16_t)chunk) == HAL_OK)
+    {
+        tx_busy = chunk;
+    }
+}
+
+/**
+ * @brief 本段发送结束，推进读指针并继续发送
+ */
+static void tx_chunk_done(void)
+{
+    tx_tail += tx_busy;
+    tx_busy = 0;
+    tx_kick();
+}
+
+uint32_t USART1_TxDropped(void)
+{
+    return tx_dropped;
+}
+
+void USART1_TxFlush(void)
+{
+    uint32_t t0 = HAL_GetTick();
+
+    while (tx_head != tx_tail)
+    {
+        /* tx_kick() 启动 DMA 失败（如 PCM 采集占用串口返回 HAL_BUSY）时不会再有完成中断，
+         * 在这里重试；超时后放弃，避免 Error_Handler() 之前的输出变成死等 */
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        tx_kick();
+        __set_PRIMASK(primask);
+
+        if (HAL_GetTick() - t0 >= USART_TX_FLUSH_MS)
+        {
+            return;
+        }
+    }
+}
+
+bool USART1_ReadByte(uint8_t *ch)
+{
+    /* 接收未开中断，轮询间隔过长时溢出标志会阻止后续接收，先清除 */
+    if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_ORE))
+    {
+        __HAL_UART_CLEAR_OREFLAG(&huart1);
+    }
+
+    if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RXNE))
+    {
+        return false;
+    }
+
+    *ch = (uint8_t)(huart1.Instance->RDR & 0xFFU);
+    return true;
+}
+
+HAL_StatusTypeDef USART1_Write(const uint8_t *buf, uint32_t len)
+{
+    uint32_t head;
+    uint32_t offset;
+    uint32_t first;
+    uint32_t primask;
+
+    if (huart1.Instance == NULL || len == 0U)
+    {
+        return HAL_OK;
+    }
+
+    /* 空间不足时整段丢弃并计数，不阻塞主循环，也不输出半截帧 */
+    head = tx_head;
+    if (len > USART_TX_RING_SIZE - (head - tx_tail))
+    {
+        tx_dropped += len;
+        return HAL_BUSY;
+    }
+
+    offset = head & (USART_TX_RING_SIZE - 1U);
+    first = USART_TX_RING_SIZE - offset;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&tx_ring[offset], buf, first);
+    memcpy(&tx_ring[0], buf + first, len - first);
+
+    /* 与发送完成中断互斥地启动 DMA */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    tx_head = head + len;
+    tx_kick();
+    __set_PRIMASK(primask);
+
+    return HAL_OK;
+}
+
 int _write(int file, char *ptr, int len)
 {
     (void)file;
-    if (huart1.Instance == NULL)
+    if (len > 0)
     {
-        return len;
+        (void)USART1_Write((const uint8_t *)ptr, (uint32_t)len);
     }
-    HAL_UART_Transmit(&huart1, (uint8_t *)ptr, len, HAL_MAX_DELAY);
     return len;
 }
+
+/**
+ * @brief HAL 串口发送完成中断回调
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance != USART1)
+    {
+        return;
+    }
+
+    if (tx_busy != 0U)
+    {
+        tx_chunk_done();
+    }
+#if PCM_CAPTURE_ENABLE
+    else
+    {
+        pcm_capture_tx_cplt_callback();
+    }
+#endif
+}
+
+/**
+ * @brief HAL 串口错误回调：放弃当前段，避免发送环停滞
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART1 && tx_busy != 0U && huart->gState == HAL_UART_STATE_READY)
+    {
+        tx_dropped += tx_busy;
+        tx_chunk_done();
+    }
+}
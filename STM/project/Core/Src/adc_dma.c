@@ -1,10 +1,18 @@
 #include "adc_dma.h"
 
 ADC_HandleTypeDef hadc1;
+#if ADC_DUAL_SIMULT_ENABLE
+ADC_HandleTypeDef hadc2;
+#endif
 DMA_HandleTypeDef hdma_adc1;
 TIM_HandleTypeDef htim2;
 
 static void MX_TIM2_Init(void);
+static uint32_t tim2_period(uint32_t fs_hz);
+static void adc_config_oversampling(ADC_HandleTypeDef *hadc);
+#if ADC_DUAL_SIMULT_ENABLE
+static void MX_ADC2_Init(void);
+#endif
 
 void MX_ADC1_Init(void)
 {
@@ -33,24 +41,40 @@ void MX_ADC1_Init(void)
     hadc1.Instance = ADC1;
     hadc1.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV2;
     hadc1.Init.Resolution = ADC_RESOLUTION_16B;
+#if ADC_DUAL_SIMULT_ENABLE
+    /* 双 ADC 同步模式：ADC1 只采 CH0，CH1 由 ADC2 同时采样 */
+    hadc1.Init.ScanConvMode = ADC_SCAN_DISABLE;
+    hadc1.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+    hadc1.Init.NbrOfConversion = 1;
+#else
     hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
     hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+    hadc1.Init.NbrOfConversion = 2;
+#endif
     hadc1.Init.LowPowerAutoWait = DISABLE;
     hadc1.Init.ContinuousConvMode = DISABLE;
-    hadc1.Init.NbrOfConversion = 2;
     hadc1.Init.DiscontinuousConvMode = DISABLE;
     hadc1.Init.ExternalTrigConv = ADC_EXTERNALTRIG_T2_TRGO;
     hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
     hadc1.Init.ConversionDataManagement = ADC_CONVERSIONDATA_DMA_CIRCULAR;
     hadc1.Init.Overrun = ADC_OVR_DATA_PRESERVED;
     hadc1.Init.LeftBitShift = ADC_LEFTBITSHIFT_NONE;
-    hadc1.Init.OversamplingMode = DISABLE;
+    adc_config_oversampling(&hadc1);
     if (HAL_ADC_Init(&hadc1) != HAL_OK)
     {
         Error_Handler();
     }
 
+#if ADC_DUAL_SIMULT_ENABLE
+    MX_ADC2_Init();
+
+    /* 规则组同步，CDR = [ADC2:ADC1] 打包为 32 位，与单 ADC 的交错布局一致 */
+    multimode.Mode = ADC_DUALMODE_REGSIMULT;
+    multimode.DualModeData = ADC_DUALMODEDATAFORMAT_32_10_BITS;
+    multimode.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_1CYCLE;
+#else
     multimode.Mode = ADC_MODE_INDEPENDENT;
+#endif
     if (HAL_ADCEx_MultiModeConfigChannel(&hadc1, &multimode) != HAL_OK)
     {
         Error_Handler();
@@ -68,27 +92,208 @@ void MX_ADC1_Init(void)
         Error_Handler();
     }
 
+#if ADC_DUAL_SIMULT_ENABLE
+    sConfig.Channel = ADC_CHANNEL_1;
+    sConfig.Rank = ADC_REGULAR_RANK_1;
+    if (HAL_ADC_ConfigChannel(&hadc2, &sConfig) != HAL_OK)
+    {
+        Error_Handler();
+    }
+#else
     sConfig.Channel = ADC_CHANNEL_1;
     sConfig.Rank = ADC_REGULAR_RANK_2;
     if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
     {
         Error_Handler();
     }
+#endif
+}
+
+/*
+ * 过采样配置：每个 TIM2 触发转换一次 (MULTI_TRIGGER)，累加 ADC_OVS_RATIO 次后
+ * 右移 ADC_OVS_SHIFT 位产生一个输出字并发出 DMA 请求，输出速率仍为采样率。
+ */
+static void adc_config_oversampling(ADC_HandleTypeDef *hadc)
+{
+#if ADC_OVERSAMPLING_ENABLE
+    hadc->Init.OversamplingMode = ENABLE;
+    hadc->Init.Oversampling.Ratio = ADC_OVS_RATIO;
+    hadc->Init.Oversampling.RightBitShift = (uint32_t)ADC_OVS_SHIFT << ADC_CFGR2_OVSS_Pos;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_MULTI_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+#else
+    hadc->Init.OversamplingMode = DISABLE;
+#endif
+}
+
+#if ADC_DUAL_SIMULT_ENABLE
+/*
+ * ADC2 作为双 ADC 模式的从机，转换由 ADC1 的触发同步启动，
+ * 自身的触发与 DMA 设置不生效。
+ */
+static void MX_ADC2_Init(void)
+{
+    hadc2.Instance = ADC2;
+    hadc2.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV2;
+    hadc2.Init.Resolution = ADC_RESOLUTION_16B;
+    hadc2.Init.ScanConvMode = ADC_SCAN_DISABLE;
+    hadc2.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+    hadc2.Init.LowPowerAutoWait = DISABLE;
+    hadc2.Init.ContinuousConvMode = DISABLE;
+    hadc2.Init.NbrOfConversion = 1;
+    hadc2.Init.DiscontinuousConvMode = DISABLE;
+    hadc2.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    hadc2.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    hadc2.Init.ConversionDataManagement = ADC_CONVERSIONDATA_DMA_CIRCULAR;
+    hadc2.Init.Overrun = ADC_OVR_DATA_PRESERVED;
+    hadc2.Init.LeftBitShift = ADC_LEFTBITSHIFT_NONE;
+    adc_config_oversampling(&hadc2);
+    if (HAL_ADC_Init(&hadc2) != HAL_OK)
+    {
+        Error_Handler();
+    }
 }
+#endif
 
-HAL_StatusTypeDef ADC_DMA_Start(uint16_t *buffer, uint32_t length)
+/*
+ * DMA 以双缓冲模式启动：buf0 -> M0AR, buf1 -> M1AR，每个存储器写满 length 个
+ * 半字即触发一次传输完成中断。两个存储器的完成事件都转发到
+ * HAL_ADC_ConvCpltCallback，不使用半传输中断。
+ * 双 ADC 模式下 DMA 从公共 CDR 以字为单位搬运，每次一个采样对。
+ */
+HAL_StatusTypeDef ADC_DMA_Start(uint16_t *buf0, uint16_t *buf1, uint32_t length)
 {
-    if (buffer == NULL || length == 0)
+    if (buf0 == NULL || buf1 == NULL || length == 0)
     {
         return HAL_ERROR;
     }
 
-    if (HAL_TIM_Base_Start(&htim2) != HAL_OK)
+    if (ADC_Enable(&hadc1) != HAL_OK)
     {
         return HAL_ERROR;
     }
+#if ADC_DUAL_SIMULT_ENABLE
+    if (ADC_Enable(&hadc2) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+#endif
+
+    ADC_STATE_CLR_SET(hadc1.State,
+                      HAL_ADC_STATE_READY | HAL_ADC_STATE_REG_EOC | HAL_ADC_STATE_REG_OVR | HAL_ADC_STATE_REG_EOSMP,
+                      HAL_ADC_STATE_REG_BUSY);
+    ADC_CLEAR_ERRORCODE(&hadc1);
+
+    hdma_adc1.XferCpltCallback = ADC_DMAConvCplt;
+    hdma_adc1.XferM1CpltCallback = ADC_DMAConvCplt;
+    hdma_adc1.XferHalfCpltCallback = NULL;
+    hdma_adc1.XferM1HalfCpltCallback = NULL;
+    hdma_adc1.XferErrorCallback = ADC_DMAError;
+
+    __HAL_ADC_CLEAR_FLAG(&hadc1, (ADC_FLAG_EOC | ADC_FLAG_EOS | ADC_FLAG_OVR));
+    __HAL_ADC_ENABLE_IT(&hadc1, ADC_IT_OVR);
+    LL_ADC_REG_SetDataTransferMode(hadc1.Instance, (uint32_t)hadc1.Init.ConversionDataManagement);
 
-    return HAL_ADC_Start_DMA(&hadc1, (uint32_t *)buffer, length);
+#if ADC_DUAL_SIMULT_ENABLE
+    if (HAL_DMAEx_MultiBufferStart_IT(&hdma_adc1, (uint32_t)&ADC12_COMMON->CDR,
+                                      (uint32_t)buf0, (uint32_t)buf1, length / 2U) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+#else
+    if (HAL_DMAEx_MultiBufferStart_IT(&hdma_adc1, (uint32_t)&hadc1.Instance->DR,
+                                      (uint32_t)buf0, (uint32_t)buf1, length) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+#endif
+
+    /* 外部触发：转换在 TIM2 的下一个 TRGO 开始 */
+    LL_ADC_REG_StartConversion(hadc1.Instance);
+
+    return HAL_TIM_Base_Start(&htim2);
+}
+
+/*
+ * 在传输完成中断中调用：CT 指示 DMA 正在写入的存储器，
+ * 将下一帧的目标地址写入另一个（空闲）存储器地址寄存器。
+ */
+HAL_StatusTypeDef ADC_DMA_SetNextBuffer(uint16_t *buffer)
+{
+    DMA_Stream_TypeDef *stream = (DMA_Stream_TypeDef *)hdma_adc1.Instance;
+
+    if (buffer == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    if ((stream->CR & DMA_SxCR_CT) != 0U)
+    {
+        return HAL_DMAEx_ChangeMemory(&hdma_adc1, (uint32_t)buffer, MEMORY0);
+    }
+    return HAL_DMAEx_ChangeMemory(&hdma_adc1, (uint32_t)buffer, MEMORY1);
+}
+
+/*
+ * 停止触发定时器、ADC 转换和 DMA 流，之后可重新调用 ADC_DMA_Start()
+ */
+HAL_StatusTypeDef ADC_DMA_Stop(void)
+{
+    if (HAL_TIM_Base_Stop(&htim2) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+#if ADC_DUAL_SIMULT_ENABLE
+    return HAL_ADCEx_MultiModeStop_DMA(&hadc1);
+#else
+    return HAL_ADC_Stop_DMA(&hadc1);
+#endif
+}
+
+/*
+ * 修改输出采样率（需在 ADC_DMA_Stop() 之后、ADC_DMA_Start() 之前调用）
+ */
+HAL_StatusTypeDef ADC_DMA_SetSampleRate(uint32_t fs_hz)
+{
+    if (fs_hz == 0U || fs_hz > FS_HZ_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    __HAL_TIM_SET_PRESCALER(&htim2, 0U);
+    __HAL_TIM_SET_AUTORELOAD(&htim2, tim2_period(fs_hz));
+    __HAL_TIM_SET_COUNTER(&htim2, 0U);
+    htim2.Init.Period = tim2_period(fs_hz);
+
+    return HAL_OK;
+}
+
+/*
+ * TIM2 计数时钟：APB1 定时器时钟，APB1 不分频时等于 PCLK1，否则为 2*PCLK1
+ */
+static uint32_t tim2_clock_hz(void)
+{
+    RCC_ClkInitTypeDef clk = {0};
+    uint32_t flash_latency;
+
+    HAL_RCC_GetClockConfig(&clk, &flash_latency);
+    if (clk.APB1CLKDivider == RCC_APB1_DIV1)
+    {
+        return HAL_RCC_GetPCLK1Freq();
+    }
+    return HAL_RCC_GetPCLK1Freq() * 2U;
+}
+
+/*
+ * Timer 触发频率 = TIM2CLK / (PSC+1) / (ARR+1) = fs_hz * ADC_TRIGGERS_PER_SAMPLE
+ * TIM2 为 32 位计数器，PSC 固定为 0
+ */
+static uint32_t tim2_period(uint32_t fs_hz)
+{
+    uint32_t trig_hz = fs_hz * ADC_TRIGGERS_PER_SAMPLE;
+
+    return (tim2_clock_hz() + trig_hz / 2U) / trig_hz - 1U;
 }
 
 static void MX_TIM2_Init(void)
@@ -97,11 +302,10 @@ static void MX_TIM2_Init(void)
 
     __HAL_RCC_TIM2_CLK_ENABLE();
 
-    /* Timer 触发频率 = 240MHz / (PSC+1) / (ARR+1) = 48kHz */
     htim2.Instance = TIM2;
-    htim2.Init.Prescaler = 49;
+    htim2.Init.Prescaler = 0;
     htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
-    htim2.Init.Period = 99;
+    htim2.Init.Period = tim2_period(FS_HZ);
     htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
     htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
     if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
@@ -138,8 +342,13 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef *adcHandle)
         hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
         hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
         hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+#if ADC_DUAL_SIMULT_ENABLE
+        hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+        hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+#else
         hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
         hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+#endif
         hdma_adc1.Init.Mode = DMA_CIRCULAR;
         hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;
         hdma_adc1.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
@@ -153,6 +362,13 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef *adcHandle)
         HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, 0, 0);
         HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
     }
+#if ADC_DUAL_SIMULT_ENABLE
+    else if (adcHandle->Instance == ADC2)
+    {
+        /* ADC1/ADC2 共用时钟，PA1 已在 ADC1 中配置 */
+        __HAL_RCC_ADC12_CLK_ENABLE();
+    }
+#endif
 }
 
 void HAL_ADC_MspDeInit(ADC_HandleTypeDef *adcHandle)
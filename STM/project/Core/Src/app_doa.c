@@ -4,14 +4,32 @@
  */
 #include "app_doa.h"
 #include "audio_frame.h"
+#include "frame_window.h"
 #include "gcc_phat.h"
 #include "servo_ctrl.h"
+#include "adc_dma.h"
+#include "USART.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "deadline.h"
 #include "config.h"
 #include <stdio.h>
 
-/* 音频帧缓冲区 */
-static float frame_x1[FRAME_N];
-static float frame_x2[FRAME_N];
+/* 运行时档位表，第 0 项为上电默认档位 */
+static const app_doa_profile_t doa_profiles[] = {
+    {FS_HZ, FRAME_N, FFT_L}, /* 默认: 48 kHz / 1024 点, 21.3 ms */
+    {48000U, 512U, 1024U},   /* 低延迟: 10.7 ms */
+    {48000U, 256U, 512U},    /* 快速跟踪: 5.3 ms */
+    {16000U, 512U, 1024U},   /* 低功耗: 32 ms */
+    {32000U, 1024U, 2048U},  /* 32 ms */
+    {96000U, 1024U, 2048U},  /* 高分辨率: 10.7 ms */
+    {96000U, 2048U, 4096U},  /* 高分辨率长帧: 21.3 ms */
+};
+
+#define DOA_PROFILE_COUNT (sizeof(doa_profiles) / sizeof(doa_profiles[0]))
+
+/* 当前档位 */
+static uint32_t profile_index = 0;
 
 /* GCC-PHAT 结果 */
 static gcc_phat_result_t gcc_result;
@@ -19,12 +37,66 @@ static gcc_phat_result_t gcc_result;
 /* 平滑后的角度 */
 static float theta_smooth = 0.0f;
 
+/* gcc_result 自上次 app_doa_get_result() 以来已更新 */
+static bool result_fresh = false;
+
 /* 调试信息 */
 static float debug_lag_sub = 0.0f;
 static float debug_dt = 0.0f;
 static float debug_theta = 0.0f;
 static float debug_peak = 0.0f;
 static float debug_ratio = 0.0f;
+static uint32_t debug_cycles_gcc = 0;
+static uint32_t debug_cycles_total = 0;
+
+#if DEADLINE_SHED_POLICY == DEADLINE_SHED_INTERP
+/* 降级前的插值方式，恢复时还原 */
+static gcc_phat_interp_t shed_saved_interp = (gcc_phat_interp_t)GCC_INTERP_MODE;
+#endif
+
+/**
+ * @brief 使能 DWT 周期计数器，用于统计处理耗时
+ */
+static void cycle_counter_enable(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief 执行过载降级或恢复动作
+ * @param evt deadline_end() 返回的状态变化
+ * @note 跳帧策略在 app_doa_process_frame() 中按 deadline_shedding() 直接执行；
+ *       其余动作在已超预算的 hop 内执行，只切换 gcc_phat_configure() 时预先准备好的配置，
+ *       不重建表格、不重新实测，也不清空递归平均
+ */
+static void load_shed_apply(deadline_event_t evt)
+{
+    if (evt == DEADLINE_EVT_NONE)
+    {
+        return;
+    }
+
+#if DEADLINE_SHED_POLICY == DEADLINE_SHED_FFT
+    {
+        /* 去掉零填充：FFT 长度减半，短于帧长时 gcc_phat_switch_fft_len() 拒绝，不降级 */
+        const app_doa_profile_t *p = &doa_profiles[profile_index];
+        uint32_t fft_l = (evt == DEADLINE_EVT_SHED) ? p->fft_l / 2U : p->fft_l;
+
+        (void)gcc_phat_switch_fft_len(fft_l);
+    }
+#elif DEADLINE_SHED_POLICY == DEADLINE_SHED_INTERP
+    if (evt == DEADLINE_EVT_SHED)
+    {
+        shed_saved_interp = gcc_phat_get_interp();
+        gcc_phat_switch_interp(GCC_PHAT_INTERP_PARABOLIC);
+    }
+    else
+    {
+        gcc_phat_switch_interp(shed_saved_interp);
+    }
+#endif
+}
 
 /**
  * @brief 初始化 DOA 系统
@@ -32,14 +104,99 @@ static float debug_ratio = 0.0f;
 HAL_StatusTypeDef app_doa_init(void)
 {
     /* 初始化各模块 */
+    cycle_counter_enable(); /* gcc_phat_init() 用它实测选择逆变换方式 */
+#if PROFILE_ENABLE
+    profile_init();
+    profile_set_budget(FS_HZ, FRAME_N / FRAME_HOP_DIV);
+#endif
     gcc_phat_init();
     servo_ctrl_init();
 
     /* 初始化平滑角度 */
     theta_smooth = 0.0f;
+    profile_index = 0;
 
     /* 初始化音频帧采集 */
-    return audio_frame_init();
+    /* 按步长启动采集，每个 DMA 帧为一个 hop */
+    if (frame_window_configure(FRAME_N, FRAME_N / FRAME_HOP_DIV) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    deadline_configure(FS_HZ, FRAME_N / FRAME_HOP_DIV);
+    return audio_frame_start(FRAME_N / FRAME_HOP_DIV);
+}
+
+/**
+ * @brief 切换采样档位
+ */
+HAL_StatusTypeDef app_doa_set_profile(uint32_t index)
+{
+    const app_doa_profile_t *p;
+
+    if (index >= DOA_PROFILE_COUNT)
+    {
+        return HAL_ERROR;
+    }
+    p = &doa_profiles[index];
+
+    /* 停止采集后依次重配定时器、算法和 DMA 帧长度 */
+    if (audio_frame_stop() != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    if (deadline_shedding())
+    {
+        load_shed_apply(DEADLINE_EVT_RESTORE); /* 先撤销降级，新档位以完整配置开始 */
+    }
+    if (ADC_DMA_SetSampleRate(p->fs_hz) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    if (gcc_phat_configure(p->fs_hz, p->frame_n, p->fft_l) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    if (frame_window_configure(p->frame_n, p->frame_n / FRAME_HOP_DIV) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    profile_index = index;
+    deadline_configure(p->fs_hz, p->frame_n / FRAME_HOP_DIV);
+#if PROFILE_ENABLE
+    /* 旧档位的统计与新预算不可比，重新开始累计 */
+    profile_reset();
+    profile_set_budget(p->fs_hz, p->frame_n / FRAME_HOP_DIV);
+#endif
+    return audio_frame_start(p->frame_n / FRAME_HOP_DIV);
+}
+
+/**
+ * @brief 获取档位参数
+ */
+const app_doa_profile_t *app_doa_get_profile(uint32_t index)
+{
+    if (index >= DOA_PROFILE_COUNT)
+    {
+        return NULL;
+    }
+    return &doa_profiles[index];
+}
+
+/**
+ * @brief 获取当前档位编号
+ */
+uint32_t app_doa_current_profile(void)
+{
+    return profile_index;
+}
+
+/**
+ * @brief 档位数量
+ */
+uint32_t app_doa_profile_count(void)
+{
+    return DOA_PROFILE_COUNT;
 }
 
 /**
@@ -55,11 +212,39 @@ bool app_doa_frame_ready(void)
  */
 void app_doa_process_frame(void)
 {
-    /* 获取帧数据 */
-    audio_frame_get(frame_x1, frame_x2);
+    const float *x1;
+    const float *x2;
+    uint32_t start;
+    uint32_t t_begin = DWT->CYCCNT;
 
-    /* 执行 GCC-PHAT */
-    gcc_phat_process(frame_x1, frame_x2, &gcc_result);
+    /* 推入一个 hop，分析窗未填满时不做估计 */
+    if (!frame_window_push())
+    {
+        return;
+    }
+#if PROFILE_ENABLE
+    profile_record(PROF_FRAME_GET, DWT->CYCCNT - t_begin);
+#endif
+
+#if DEADLINE_SHED_POLICY == DEADLINE_SHED_SKIP
+    /* 跳帧降级：隔一个 hop 估计一次，已有 hop 排队时直接追赶（历史环照常更新） */
+    if (deadline_shedding() && (audio_frame_available() || (frame_window_seq() & 1U) != 0U))
+    {
+        (void)deadline_end(frame_window_seq(), t_begin);
+        return;
+    }
+#endif
+
+    /* 对滑动窗执行 GCC-PHAT */
+    start = frame_window_get(&x1, &x2);
+    debug_cycles_gcc = DWT->CYCCNT;
+    gcc_phat_process_ring(x1, x2, start, &gcc_result);
+    debug_cycles_gcc = DWT->CYCCNT - debug_cycles_gcc;
+    result_fresh = true;
+#if PROFILE_ENABLE
+    profile_record(PROF_GCC_TOTAL, debug_cycles_gcc);
+#endif
+    PROFILE_BEGIN(PROF_OUTPUT);
 
     /* 保存调试信息 */
     debug_lag_sub = gcc_result.lag_sub;
@@ -79,6 +264,50 @@ void app_doa_process_frame(void)
         servo_ctrl_set_angle(theta_smooth);
     }
     /* 如果结果无效，保持原角度不变 */
+
+    debug_cycles_total = DWT->CYCCNT - t_begin;
+
+#if TELEMETRY_ENABLE
+    {
+        telemetry_record_t rec;
+
+        rec.flags = gcc_result.valid ? TELEMETRY_FLAG_VALID : 0U;
+        rec.seq = frame_window_seq();
+        rec.lag_sub = gcc_result.lag_sub;
+        rec.dt = gcc_result.dt;
+        rec.theta_deg = gcc_result.theta_deg;
+        rec.peak = gcc_result.peak;
+        rec.ratio = gcc_result.ratio;
+        rec.theta_smooth = theta_smooth;
+        rec.cycles_gcc = debug_cycles_gcc;
+        rec.cycles_total = debug_cycles_total;
+        telemetry_send(&rec);
+    }
+#endif
+
+    PROFILE_END(PROF_OUTPUT);
+#if PROFILE_ENABLE
+    profile_record(PROF_FRAME_TOTAL, DWT->CYCCNT - t_begin);
+#endif
+
+    load_shed_apply(deadline_end(frame_window_seq(), t_begin));
+}
+
+/**
+ * @brief 读取最近一次估计结果
+ */
+bool app_doa_get_result(gcc_phat_result_t *result, float *theta_smooth_out)
+{
+    bool fresh = result_fresh;
+
+    *result = gcc_result;
+    if (theta_smooth_out != NULL)
+    {
+        *theta_smooth_out = theta_smooth;
+    }
+    result_fresh = false;
+
+    return fresh;
 }
 
 /**
@@ -94,12 +323,24 @@ void app_doa_servo_update(void)
  */
 void app_doa_debug_print(void)
 {
-    printf("lag:%.2f dt:%.6f theta:%.1f peak:%.3f ratio:%.2f smooth:%.1f %s\r\n",
+    audio_frame_stats_t stats;
+    deadline_stats_t dl;
+
+    audio_frame_get_stats(&stats);
+    deadline_get_stats(&dl);
+    printf("lag:%.2f dt:%.6f theta:%.1f peak:%.3f ratio:%.2f smooth:%.1f cyc:%lu drop:%lu txdrop:%lu "
+           "load:%lu%% miss:%lu%s %s\r\n",
            debug_lag_sub,
            debug_dt,
            debug_theta,
            debug_peak,
            debug_ratio,
            theta_smooth,
+           (unsigned long)debug_cycles_total,
+           (unsigned long)stats.frames_dropped,
+           (unsigned long)USART1_TxDropped(),
+           (unsigned long)dl.load_pct,
+           (unsigned long)dl.misses,
+           dl.shedding ? " SHED" : "",
            gcc_result.valid ? "OK" : "SKIP");
 }
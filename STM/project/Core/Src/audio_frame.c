@@ -1,31 +1,104 @@
 /**
  * @file audio_frame.c
  * @brief DMA 音频帧管理模块实现
+ *
+ * DMA 工作在双缓冲模式，M0AR/M1AR 轮流指向环形缓冲区中的空闲槽位。
+ * 每写满一个槽位，传输完成中断将其压入就绪队列（生产者），
+ * 主循环按顺序取用并释放（消费者）。队列为单生产者单消费者，无需关中断。
  */
 #include "audio_frame.h"
 #include "adc_dma.h"
+#include "deadline.h"
 #include <string.h>
 
-/* DMA 缓冲区 - 放在 D2 SRAM 避免 DCache 问题 */
-/* 双通道交错存储: [CH0, CH1, CH0, CH1, ...] */
-__attribute__((section(".bss"), aligned(32))) static uint16_t dma_buffer[DMA_BUFFER_SIZE];
+/* DMA 缓冲区 - 放在 D2 SRAM (.dma_d2)，MPU 配置为不可缓存，无需 DCache 维护 */
+/* 每个槽位一帧，双通道交错存储: [CH0, CH1, CH0, CH1, ...] */
+__attribute__((section(".dma_d2"), aligned(32))) static uint16_t dma_buffer[AUDIO_RING_SLOTS][DMA_FRAME_SIZE_MAX];
 
-/* 帧就绪标志 */
-static volatile bool frame_ready = false;
-static volatile uint8_t active_half = 0; /* 0: 前半, 1: 后半 */
+/* 当前帧长度（采样对数），由 audio_frame_start() 设定 */
+static uint32_t frame_len = FRAME_N;
+
+/* 就绪队列条目 */
+typedef struct
+{
+    uint32_t seq;  /* 帧序号 */
+    uint32_t tick; /* 写满时的 HAL_GetTick() */
+    uint8_t slot;  /* 所在槽位 */
+} ring_entry_t;
+
+/* 就绪队列：已写满但尚未释放的帧 */
+static ring_entry_t ring_queue[AUDIO_RING_SLOTS];
+static volatile uint32_t ring_wr = 0; /* 生产者索引，仅中断写 */
+static volatile uint32_t ring_rd = 0; /* 消费者索引，仅主循环写 */
+
+/* DMA 正在写入的槽位与已排队的下一槽位，仅中断访问 */
+static uint8_t dma_slot_active = 0;
+static uint8_t dma_slot_next = 1;
+
+/* 按 32 位读取交错采样对，允许与 uint16_t 缓冲区别名 */
+typedef uint32_t __attribute__((may_alias)) pcm_pair_t;
+
+/* 采样对 [CH1:CH0] 的两个通道同时由偏移码转为补码 */
+#define PCM_PAIR_OFFSET 0x80008000UL
+
+/* 归一化系数 1/32768 */
+#define PCM_SCALE (1.0f / 32768.0f)
+
+/* 统计 */
+static volatile uint32_t capture_seq = 0;
+static volatile uint32_t frames_dropped = 0;
+static volatile uint32_t max_pending = 0;
 
 /**
  * @brief 初始化音频帧模块
  */
 HAL_StatusTypeDef audio_frame_init(void)
 {
+    return audio_frame_start(FRAME_N);
+}
+
+/**
+ * @brief 以指定帧长度启动采集
+ */
+HAL_StatusTypeDef audio_frame_start(uint32_t frame_n)
+{
+    if (frame_n == 0U || frame_n > FRAME_N_MAX)
+    {
+        return HAL_ERROR;
+    }
+
     /* 清零缓冲区 */
     memset(dma_buffer, 0, sizeof(dma_buffer));
-    frame_ready = false;
-    active_half = 0;
+    frame_len = frame_n;
+    ring_wr = 0;
+    ring_rd = 0;
+    dma_slot_active = 0;
+    dma_slot_next = 1;
+    capture_seq = 0;
+    frames_dropped = 0;
+    max_pending = 0;
 
     /* 启动 ADC DMA 采集 */
-    return ADC_DMA_Start(dma_buffer, DMA_BUFFER_SIZE);
+    return ADC_DMA_Start(dma_buffer[0], dma_buffer[1], frame_n * 2U);
+}
+
+/**
+ * @brief 停止采集，丢弃所有待处理帧
+ */
+HAL_StatusTypeDef audio_frame_stop(void)
+{
+    HAL_StatusTypeDef status = ADC_DMA_Stop();
+
+    ring_rd = ring_wr;
+    return status;
+}
+
+/**
+ * @brief 当前帧长度
+ */
+uint32_t audio_frame_length(void)
+{
+    return frame_len;
 }
 
 /**
@@ -33,75 +106,190 @@ HAL_StatusTypeDef audio_frame_init(void)
  */
 bool audio_frame_available(void)
 {
-    return frame_ready;
+    return ring_rd != ring_wr;
 }
 
 /**
- * @brief 获取帧数据并转换为浮点
+ * @brief 获取最早的待处理帧
  */
-void audio_frame_get(float *x1, float *x2)
+const uint16_t *audio_frame_acquire(uint32_t *seq)
 {
-    uint16_t *src;
-    uint32_t i;
+    uint32_t rd = ring_rd;
+    const uint16_t *src;
 
-    /* 根据活动半区选择数据源 */
-    if (active_half == 0)
+    if (rd == ring_wr)
     {
-        /* 使用后半缓冲区（前半正在 DMA） */
-        src = &dma_buffer[DMA_BUFFER_SIZE / 2];
+        return NULL;
     }
-    else
+
+    src = dma_buffer[ring_queue[rd % AUDIO_RING_SLOTS].slot];
+
+    if (seq != NULL)
     {
-        /* 使用前半缓冲区（后半正在 DMA） */
-        src = &dma_buffer[0];
+        *seq = ring_queue[rd % AUDIO_RING_SLOTS].seq;
     }
 
-    /* STM32H7 DCache 失效处理 */
-    SCB_InvalidateDCache_by_Addr((uint32_t *)src, DMA_BUFFER_SIZE);
+    return src;
+}
+
+/**
+ * @brief 最早待处理帧写满时的系统节拍
+ */
+uint32_t audio_frame_tick(void)
+{
+    return ring_queue[ring_rd % AUDIO_RING_SLOTS].tick;
+}
+
+/**
+ * @brief 释放已取用的帧
+ */
+void audio_frame_release(void)
+{
+    uint32_t rd = ring_rd;
 
-    /* 分离双通道并转换为浮点 [-1, 1] */
-    for (i = 0; i < FRAME_N; i++)
+    if (rd != ring_wr)
     {
-        /* ADC 16位数据，转换为归一化浮点 */
-        x1[i] = ((float)src[i * 2] / 32768.0f) - 1.0f;
-        x2[i] = ((float)src[i * 2 + 1] / 32768.0f) - 1.0f;
+        ring_rd = rd + 1U;
     }
+}
+
+/**
+ * @brief 双通道去交错并转换为浮点
+ *
+ * 每个 32 位字包含一对采样 [CH1:CH0]。一次异或同时完成两个通道的
+ * 减 32768，低半字符号扩展 / 高半字算术右移即得两路有符号值，
+ * 再乘以倒数归一化，避免逐点除法。
+ */
+void audio_frame_to_float(const uint16_t *src, float *x1, float *x2, uint32_t n)
+{
+    const pcm_pair_t *pairs = (const pcm_pair_t *)src;
+    uint32_t i = 0;
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        uint32_t w0 = pairs[i] ^ PCM_PAIR_OFFSET;
+        uint32_t w1 = pairs[i + 1U] ^ PCM_PAIR_OFFSET;
+        uint32_t w2 = pairs[i + 2U] ^ PCM_PAIR_OFFSET;
+        uint32_t w3 = pairs[i + 3U] ^ PCM_PAIR_OFFSET;
+
+        x1[i] = (float)(int16_t)w0 * PCM_SCALE;
+        x2[i] = (float)((int32_t)w0 >> 16) * PCM_SCALE;
+        x1[i + 1U] = (float)(int16_t)w1 * PCM_SCALE;
+        x2[i + 1U] = (float)((int32_t)w1 >> 16) * PCM_SCALE;
+        x1[i + 2U] = (float)(int16_t)w2 * PCM_SCALE;
+        x2[i + 2U] = (float)((int32_t)w2 >> 16) * PCM_SCALE;
+        x1[i + 3U] = (float)(int16_t)w3 * PCM_SCALE;
+        x2[i + 3U] = (float)((int32_t)w3 >> 16) * PCM_SCALE;
+    }
+
+    for (; i < n; i++)
+    {
+        uint32_t w = pairs[i] ^ PCM_PAIR_OFFSET;
 
-    /* 清除帧就绪标志 */
-    frame_ready = false;
+        x1[i] = (float)(int16_t)w * PCM_SCALE;
+        x2[i] = (float)((int32_t)w >> 16) * PCM_SCALE;
+    }
 }
 
 /**
- * @brief DMA 半传输完成回调
+ * @brief 获取帧数据并转换为浮点
  */
-void audio_frame_half_cplt_callback(void)
+void audio_frame_get(float *x1, float *x2)
 {
-    active_half = 0;
-    frame_ready = true;
+    const uint16_t *src = audio_frame_acquire(NULL);
+
+    if (src == NULL)
+    {
+        return;
+    }
+
+    audio_frame_to_float(src, x1, x2, frame_len);
+    audio_frame_release();
 }
 
 /**
- * @brief DMA 全传输完成回调
+ * @brief 读取采集统计信息
  */
-void audio_frame_cplt_callback(void)
+void audio_frame_get_stats(audio_frame_stats_t *stats)
 {
-    active_half = 1;
-    frame_ready = true;
+    stats->frames_captured = capture_seq;
+    stats->frames_dropped = frames_dropped;
+    stats->pending = ring_wr - ring_rd;
+    stats->max_pending = max_pending;
 }
 
 /**
- * @brief HAL DMA 半传输完成中断回调
+ * @brief 查找可供 DMA 写入的空闲槽位
+ * @param done 刚写满的槽位
+ * @retval 空闲槽位编号，无空闲槽位时返回 -1
  */
-void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+static int32_t find_free_slot(uint8_t done)
 {
-    if (hadc->Instance == ADC1)
+    uint32_t busy = (1UL << dma_slot_active) | (1UL << done);
+    uint32_t wr = ring_wr;
+
+    /* 就绪队列中的槽位（含主循环正在使用的）不可覆盖 */
+    for (uint32_t i = ring_rd; i != wr; i++)
     {
-        audio_frame_half_cplt_callback();
+        busy |= 1UL << ring_queue[i % AUDIO_RING_SLOTS].slot;
     }
+
+    for (uint32_t k = 1; k < AUDIO_RING_SLOTS; k++)
+    {
+        uint32_t slot = (dma_slot_active + k) % AUDIO_RING_SLOTS;
+        if ((busy & (1UL << slot)) == 0U)
+        {
+            return (int32_t)slot;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief DMA 帧传输完成回调
+ * @note DMA 已自动切换到 dma_slot_next，这里为其后一帧准备目标槽位
+ */
+void audio_frame_cplt_callback(void)
+{
+    uint8_t done = dma_slot_active;
+    int32_t next;
+
+    deadline_dma_stamp(capture_seq);
+    dma_slot_active = dma_slot_next;
+    next = find_free_slot(done);
+
+    if (next >= 0)
+    {
+        uint32_t wr = ring_wr;
+        uint32_t pending;
+
+        ring_queue[wr % AUDIO_RING_SLOTS].slot = done;
+        ring_queue[wr % AUDIO_RING_SLOTS].seq = capture_seq;
+        ring_queue[wr % AUDIO_RING_SLOTS].tick = HAL_GetTick();
+        __DMB();
+        ring_wr = wr + 1U;
+
+        pending = ring_wr - ring_rd;
+        if (pending > max_pending)
+        {
+            max_pending = pending;
+        }
+    }
+    else
+    {
+        /* 环已满：丢弃刚写满的帧，槽位直接复用 */
+        frames_dropped++;
+        next = done;
+    }
+
+    capture_seq++;
+    dma_slot_next = (uint8_t)next;
+    ADC_DMA_SetNextBuffer(dma_buffer[next]);
 }
 
 /**
- * @brief HAL DMA 全传输完成中断回调
+ * @brief HAL DMA 传输完成中断回调（M0/M1 均由此进入）
  */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
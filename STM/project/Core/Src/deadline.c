@@ -0,0 +1,145 @@
+/**
+ * @file deadline.c
+ * @brief 帧处理截止时间监测与过载降级判决实现
+ *
+ * hop k 的截止时刻取 hop k+1 的到达时刻：此后仍未处理完，下一 hop 就要排队，
+ * 积压超过 AUDIO_RING_SLOTS 时 audio_frame 开始丢帧。
+ * 到达时刻按序号存入小环，中断只写、主循环只读，单生产者单消费者无需关中断。
+ * 降级采用长短两种保持时间：过载持续 DEADLINE_SHED_HOLD 个 hop 即降级，
+ * 恢复则需持续 DEADLINE_RESTORE_HOLD 个 hop。降级本身会压低负载，较长的恢复确认
+ * 把降级/恢复的往复限制为每 DEADLINE_RESTORE_HOLD 个 hop 至多试探一次。
+ */
+#include "deadline.h"
+#include <string.h>
+
+/* 到达时刻环长度（2 的幂），需覆盖就绪队列的最大积压 */
+#define DEADLINE_STAMPS 32U
+
+/* 负载一阶平滑系数 */
+#define DEADLINE_LOAD_ALPHA 0.125f
+
+static uint32_t dma_stamp[DEADLINE_STAMPS];
+static volatile uint32_t dma_count = 0; /* 已到达的 hop 数，即最新序号 + 1 */
+
+static uint32_t hop_cycles = 1U;
+
+static deadline_stats_t dl_stats;
+static float load_avg = 0.0f;
+static uint32_t over_cnt = 0;  /* 连续过载的 hop 数 */
+static uint32_t under_cnt = 0; /* 降级后连续低负载的 hop 数 */
+
+/**
+ * @brief 设置 hop 周期并清空状态
+ */
+void deadline_configure(uint32_t fs_hz, uint32_t hop)
+{
+    hop_cycles = (uint32_t)(((uint64_t)SystemCoreClock * hop) / fs_hz);
+    if (hop_cycles == 0U)
+    {
+        hop_cycles = 1U;
+    }
+
+    dma_count = 0;
+    memset(&dl_stats, 0, sizeof(dl_stats));
+    load_avg = 0.0f;
+    over_cnt = 0;
+    under_cnt = 0;
+}
+
+/**
+ * @brief 记录 hop 到达时刻
+ */
+void deadline_dma_stamp(uint32_t seq)
+{
+    dma_stamp[seq % DEADLINE_STAMPS] = DWT->CYCCNT;
+    __DMB();
+    dma_count = seq + 1U;
+}
+
+/**
+ * @brief 按平滑负载更新降级状态
+ */
+static deadline_event_t shed_update(void)
+{
+#if DEADLINE_SHED_POLICY == DEADLINE_SHED_NONE
+    return DEADLINE_EVT_NONE;
+#else
+    if (!dl_stats.shedding)
+    {
+        over_cnt = (load_avg > (float)DEADLINE_SHED_LOAD_PCT) ? over_cnt + 1U : 0U;
+        if (over_cnt >= DEADLINE_SHED_HOLD)
+        {
+            over_cnt = 0;
+            under_cnt = 0;
+            dl_stats.shedding = true;
+            dl_stats.shed_events++;
+            return DEADLINE_EVT_SHED;
+        }
+    }
+    else
+    {
+        under_cnt = (load_avg < (float)DEADLINE_RESTORE_LOAD_PCT) ? under_cnt + 1U : 0U;
+        if (under_cnt >= DEADLINE_RESTORE_HOLD)
+        {
+            over_cnt = 0;
+            under_cnt = 0;
+            dl_stats.shedding = false;
+            return DEADLINE_EVT_RESTORE;
+        }
+    }
+    return DEADLINE_EVT_NONE;
+#endif
+}
+
+/**
+ * @brief 一个 hop 处理完成
+ */
+deadline_event_t deadline_end(uint32_t seq, uint32_t t_begin)
+{
+    uint32_t now = DWT->CYCCNT;
+    uint32_t arrived = dma_count;
+    uint32_t load = (uint32_t)(((uint64_t)(now - t_begin) * 100U) / hop_cycles);
+
+    dl_stats.hops++;
+
+    /* 下一 hop 已到达：超过截止时刻 */
+    if ((int32_t)(arrived - (seq + 1U)) > 0)
+    {
+        dl_stats.misses++;
+
+        /* 积压未超出时刻环时才能得到超时量 */
+        if (arrived - (seq + 1U) < DEADLINE_STAMPS)
+        {
+            uint32_t late = now - dma_stamp[(seq + 1U) % DEADLINE_STAMPS];
+            if (late > dl_stats.max_late)
+            {
+                dl_stats.max_late = late;
+            }
+        }
+    }
+
+    if (load > dl_stats.load_max_pct)
+    {
+        dl_stats.load_max_pct = load;
+    }
+    load_avg += DEADLINE_LOAD_ALPHA * ((float)load - load_avg);
+    dl_stats.load_pct = (uint32_t)(load_avg + 0.5f);
+
+    return shed_update();
+}
+
+/**
+ * @brief 当前是否处于降级状态
+ */
+bool deadline_shedding(void)
+{
+    return dl_stats.shedding;
+}
+
+/**
+ * @brief 读取监测统计
+ */
+void deadline_get_stats(deadline_stats_t *stats)
+{
+    *stats = dl_stats;
+}
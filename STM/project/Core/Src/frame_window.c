@@ -0,0 +1,113 @@
+/**
+ * @file frame_window.c
+ * @brief 滑动窗帧拼接模块实现
+ *
+ * 历史环长度恰为 frame_n，且 hop 整除 frame_n，因此每个 hop 总是写入
+ * 环中一段连续区域 [wr, wr + hop)，写完后 wr 指向的即为窗口中最早的采样。
+ * 重叠部分不搬移，旧采样原地保留，直到被 frame_n/hop 个 hop 之后的新数据覆盖。
+ */
+#include "frame_window.h"
+#include "audio_frame.h"
+
+/* 浮点历史环（双通道分开存储） */
+static float hist_x1[FRAME_N_MAX];
+static float hist_x2[FRAME_N_MAX];
+
+static uint32_t win_len = FRAME_N;
+static uint32_t hop_len = FRAME_N / FRAME_HOP_DIV;
+
+static uint32_t wr_pos = 0;   /* 下一个 hop 的写入位置 */
+static uint32_t filled = 0;   /* 自上次复位以来累计的有效采样数 */
+static uint32_t next_seq = 0; /* 期望的下一帧序号 */
+
+/**
+ * @brief 设置窗长与步长
+ */
+HAL_StatusTypeDef frame_window_configure(uint32_t frame_n, uint32_t hop)
+{
+    if (frame_n == 0U || frame_n > FRAME_N_MAX || hop == 0U || (frame_n % hop) != 0U)
+    {
+        return HAL_ERROR;
+    }
+
+    win_len = frame_n;
+    hop_len = hop;
+    frame_window_reset();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 清空历史
+ */
+void frame_window_reset(void)
+{
+    wr_pos = 0;
+    filled = 0;
+    next_seq = 0;
+}
+
+/**
+ * @brief 推入一个 hop
+ */
+bool frame_window_push(void)
+{
+    uint32_t seq;
+    const uint16_t *src = audio_frame_acquire(&seq);
+
+    if (src == NULL)
+    {
+        return false;
+    }
+
+    /* 序号不连续说明中间有 hop 被丢弃，历史已不连续 */
+    if (filled != 0U && seq != next_seq)
+    {
+        wr_pos = 0;
+        filled = 0;
+    }
+    next_seq = seq + 1U;
+
+    /* 直接从 DMA 槽位转换到历史环，每个采样只写一次 */
+    audio_frame_to_float(src, &hist_x1[wr_pos], &hist_x2[wr_pos], hop_len);
+    audio_frame_release();
+
+    wr_pos += hop_len;
+    if (wr_pos >= win_len)
+    {
+        wr_pos = 0;
+    }
+
+    if (filled < win_len)
+    {
+        filled += hop_len;
+    }
+
+    return filled >= win_len;
+}
+
+/**
+ * @brief 获取当前分析窗
+ */
+uint32_t frame_window_get(const float **x1, const float **x2)
+{
+    *x1 = hist_x1;
+    *x2 = hist_x2;
+    return wr_pos;
+}
+
+/**
+ * @brief 最近推入的帧序号
+ */
+uint32_t frame_window_seq(void)
+{
+    return next_seq - 1U;
+}
+
+/**
+ * @brief 当前步长
+ */
+uint32_t frame_window_hop(void)
+{
+    return hop_len;
+}
@@ -5,189 +5,1032 @@
  * 使用 CMSIS-DSP 库实现 FFT/IFFT
  */
 #include "gcc_phat.h"
+#include "profile.h"
 #include "arm_math.h"
+#include "arm_const_structs.h"
 #include <math.h>
 #include <string.h>
 
-/* FFT 实例 */
+/*
+ * 正向 FFT 方式：
+ * 0: 两路各做一次 arm_rfft_fast_f32
+ * 1: x1 作实部、x2 作虚部打包，做一次 fft_l 点 arm_cfft_f32，
+ *    再利用共轭对称分离 X1/X2，分离与互功率谱计算合并在同一循环
+ */
+#ifndef GCC_PHAT_PACKED_FFT
+#define GCC_PHAT_PACKED_FFT 1
+#endif
+
+/* FFT 实例（逆变换及非打包模式的正变换） */
 static arm_rfft_fast_instance_f32 fft_inst;
 
-/* 汉宁窗 */
-static float hann_window[FRAME_N];
+#if GCC_PHAT_PACKED_FFT
+/* 打包模式的复数 FFT 实例 */
+static const arm_cfft_instance_f32 *cfft_inst = &arm_cfft_sR_f32_len2048;
+#endif
+
+/* 当前配置（由 gcc_phat_configure 设定） */
+static uint32_t cfg_fs_hz = FS_HZ;
+static uint32_t cfg_frame_n = FRAME_N;
+static uint32_t cfg_fft_l = FFT_L;
+static uint32_t cfg_max_lag = MAX_LAG_SAMPLES;
+
+/* gcc_phat_configure() 给出的 FFT 长度，gcc_phat_switch_fft_len() 只在其下按 2 的幂缩短：
+ * cfg_fft_l = cfg_fft_base >> cfg_fft_shift */
+static uint32_t cfg_fft_base = FFT_L;
+static uint32_t cfg_fft_shift = 0;
+
+/* 最多缩短的级数（FFT_L_MAX 到 32） */
+#define FFT_SHIFT_MAX 7U
+
+/* 几何决定的最大滞后（只受查找表容量限制），cfg_max_lag 再按当前 FFT 长度截断 */
+static uint32_t geo_max_lag = MAX_LAG_SAMPLES;
+
+/* 阵列几何（运行时可由 gcc_phat_set_geometry() 修改） */
+static float geo_mic_dist = MIC_DIST_M;
+static float geo_sound_speed = SOUND_SPEED;
+
+/* 滞后 -> 角度查找表：覆盖 ±(geo_max_lag + 1) 个采样，每采样 ANGLE_LUT_DIV 段，线性插值 */
+#define ANGLE_LUT_MAX_HALF ((ANGLE_LUT_MAX_LAG + 1U) * ANGLE_LUT_DIV)
+static float theta_lut[2U * ANGLE_LUT_MAX_HALF + 1U];
+static uint32_t lut_half = 0;        /* 零滞后在表中的下标 */
+static float lut_edge = 0.0f;        /* 查表范围 |lag| * ANGLE_LUT_DIV 的上限，之外直接计算 */
+static float cfg_sin_per_lag = 0.0f; /* sin(theta) / lag */
+static float cfg_inv_fs = 1.0f / (float)FS_HZ;
+
+/* 端射方向 asin 斜率趋于无穷，线性插值误差过大，|sin(theta)| 超过此值时改用 asinf */
+#define ANGLE_LUT_SIN_MAX 0.98f
+
+/* 有效频带 (Hz)，跨 gcc_phat_configure() 保持，按当前采样率和 FFT 长度换算为频点 */
+static uint32_t band_lo_hz = GCC_BAND_LO_HZ;
+static uint32_t band_hi_hz = GCC_BAND_HI_HZ;
+
+/* 有效频点范围 [band_k_lo, band_k_hi]，0 为直流，fft_l/2 为 Nyquist */
+static uint32_t band_k_lo = 0;
+static uint32_t band_k_hi = FFT_L / 2U;
+
+/* 限带后主瓣变宽，多峰提取时抑制已选峰两侧 |lag - peak| < band_lobe 的范围 */
+static int32_t band_lobe = 1;
+
+/* 频点加权（按频点序号索引，带外不读取），已乘以归一化系数 */
+static float band_weight[FFT_L_MAX / 2U + 1U];
+
+/* gcc_phat_set_band_weights() 设置的原始加权，按基准长度 cfg_fft_base 的频点序号索引；
+ * 缩短 FFT 时按 2^cfg_fft_shift 跨步抽取到 band_weight，恢复时不丢失奇数频点 */
+__attribute__((section(".axi_ram"), aligned(32))) static float band_weight_raw[FFT_L_MAX / 2U + 1U];
+
+/**
+ * @brief 归一化带内加权，使完全相干的信号峰值仍为 1
+ *
+ * 逆变换在零滞后处得到 (w_0 + w_{N/2} + 2 * sum w_k) / N，全频带单位加权时为 1；
+ * 限带后峰值按带宽比例下降，归一化后 PEAK_MIN 阈值与频带无关。
+ */
+static void normalize_band_weight(void)
+{
+    uint32_t half = cfg_fft_l / 2U;
+    float sum = 0.0f;
+
+    for (uint32_t k = band_k_lo; k <= band_k_hi; k++)
+    {
+        sum += (k == 0U || k == half) ? band_weight[k] : 2.0f * band_weight[k];
+    }
+
+    if (sum > 0.0f)
+    {
+        float gain = (float)cfg_fft_l / sum;
+
+        for (uint32_t k = band_k_lo; k <= band_k_hi; k++)
+        {
+            band_weight[k] *= gain;
+        }
+    }
+}
+
+/* 汉宁窗 */
+static float hann_window[FRAME_N_MAX];
+
+/* FFT 工作缓冲区 - 对齐到 32 字节，按最大档位分配
+ * 非打包模式分为 fft_buf1 / fft_buf2 两个实数输入；打包模式整体作为 fft_l 点复数缓冲区 */
+__attribute__((aligned(32))) static float fft_work[2U * FFT_L_MAX];
+
+#define fft_buf1 (&fft_work[0])
+#define fft_buf2 (&fft_work[FFT_L_MAX])
+
+__attribute__((aligned(32))) static float cross_spectrum[FFT_L_MAX];
+
+__attribute__((aligned(32))) static float gcc_output[FFT_L_MAX];
+
+/* 整周余弦表 cos(2*pi*i/cfg_fft_base)，正弦由下标偏移 3/4 周得到；缩短 FFT 时跨步再乘 2^cfg_fft_shift
+ * 读取者: GCC_PHAT_LAG_DFT 方式的 lag_dft()，以及与求值方式无关的相位斜率插值 phase_slope_interp()
+ * 按跨步读取，放在 AXI SRAM 不占用 DTCM */
+__attribute__((section(".axi_ram"), aligned(32))) static float dft_cos[FFT_L_MAX];
+
+/* 递归平均的互功率谱（PHAT 加权前），arm_rfft_fast_f32 打包格式，只读写带内频点
+ * 每帧顺序访问一遍，放在 AXI SRAM 不占用 DTCM */
+__attribute__((section(".axi_ram"), aligned(32))) static float cross_avg[FFT_L_MAX];
+
+/* 遗忘因子 lambda 与 1 - lambda；lambda 为 0 时不平均 */
+static float avg_lambda = GCC_SPEC_AVG_LAMBDA;
+static float avg_gain = 1.0f - GCC_SPEC_AVG_LAMBDA;
+
+/* 加窗 sinc 插值的单侧抽头数，直接 DFT 需多计算这么多个滞后 */
+#define SINC_HALF 8
+
+/* 亚采样插值方式 */
+static gcc_phat_interp_t interp_mode = (gcc_phat_interp_t)GCC_INTERP_MODE;
+
+/* 当前滞后窗口求值方式，由 gcc_phat_configure() 实测选择 */
+static gcc_phat_lag_eval_t lag_eval = GCC_PHAT_LAG_IFFT;
+
+/* 各缩短级数下的实测选择（按 cfg_fft_shift 索引），切换 FFT 长度时直接取用 */
+static gcc_phat_lag_eval_t lag_eval_len[FFT_SHIFT_MAX + 1U];
+
+/* 由 gcc_phat_set_lag_eval() 强制指定，实测不再覆盖 */
+static bool lag_eval_forced = false;
+
+static void recalibrate_lag_eval(void);
+static void init_band(void);
+static void init_band_bins(void);
+static void load_band_weight(void);
+static void resample_spec_avg(const float *src, uint32_t src_l);
+static void init_geometry(void);
+static void limit_max_lag(void);
+
+/**
+ * @brief 初始化汉宁窗
+ */
+static void init_hann_window(void)
+{
+    for (uint32_t n = 0; n < cfg_frame_n; n++)
+    {
+        hann_window[n] = 0.5f * (1.0f - arm_cos_f32(2.0f * PI * (float)n / (float)(cfg_frame_n - 1)));
+    }
+}
+
+/**
+ * @brief 按长度选择 CMSIS 预置复数 FFT 实例
+ * @param fft_l 32 ~ 4096 的 2 的幂（调用前已校验）
+ */
+static const arm_cfft_instance_f32 *select_cfft(uint32_t fft_l)
+{
+    switch (fft_l)
+    {
+    case 32U:
+        return &arm_cfft_sR_f32_len32;
+    case 64U:
+        return &arm_cfft_sR_f32_len64;
+    case 128U:
+        return &arm_cfft_sR_f32_len128;
+    case 256U:
+        return &arm_cfft_sR_f32_len256;
+    case 512U:
+        return &arm_cfft_sR_f32_len512;
+    case 1024U:
+        return &arm_cfft_sR_f32_len1024;
+    case 2048U:
+        return &arm_cfft_sR_f32_len2048;
+    default:
+        return &arm_cfft_sR_f32_len4096;
+    }
+}
+
+/**
+ * @brief 初始化直接 DFT 的余弦表（按基准长度，缩短后的各长度共用）
+ */
+static void init_dft_table(void)
+{
+    for (uint32_t i = 0; i < cfg_fft_base; i++)
+    {
+        dft_cos[i] = arm_cos_f32(2.0f * PI * (float)i / (float)cfg_fft_base);
+    }
+}
+
+/**
+ * @brief 当前帧长度下最多可缩短的级数：缩短后不短于帧长，也不短于 32 点
+ */
+static uint32_t fft_shift_limit(void)
+{
+    uint32_t shift = 0;
+
+    while (shift < FFT_SHIFT_MAX && (cfg_fft_base >> (shift + 1U)) >= cfg_frame_n &&
+           (cfg_fft_base >> (shift + 1U)) >= 32U)
+    {
+        shift++;
+    }
+    return shift;
+}
+
+/**
+ * @brief 切换到基准长度缩短 shift 级后的 FFT 长度
+ * @retval HAL_OK: 成功; HAL_ERROR: CMSIS 不支持该长度，保持原长度
+ * @note 只重选 FFT 实例、搜索范围截断、频点范围与加权，各项都是查表或 O(fft_l) 的复制；
+ *       汉宁窗、余弦表与角度查找表与 FFT 长度无关，不重建。求值方式取该长度缓存的实测结果
+ */
+static HAL_StatusTypeDef select_fft_len(uint32_t shift)
+{
+    uint32_t fft_l = cfg_fft_base >> shift;
+
+    if (arm_rfft_fast_init_f32(&fft_inst, (uint16_t)fft_l) != ARM_MATH_SUCCESS)
+    {
+        return HAL_ERROR;
+    }
+#if GCC_PHAT_PACKED_FFT
+    cfft_inst = select_cfft(fft_l);
+#endif
+
+    cfg_fft_l = fft_l;
+    cfg_fft_shift = shift;
+    limit_max_lag();
+    init_band_bins();
+    load_band_weight();
+
+    /* 带内频点每帧重写，带外需按新长度的排列清零 */
+    memset(cross_spectrum, 0, fft_l * sizeof(float));
+
+    if (!lag_eval_forced)
+    {
+        lag_eval = lag_eval_len[shift];
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 初始化 GCC-PHAT 模块
+ */
+void gcc_phat_init(void)
+{
+    (void)gcc_phat_configure(FS_HZ, FRAME_N, FFT_L);
+}
+
+/**
+ * @brief 切换采样率 / 帧长度 / FFT 长度
+ */
+HAL_StatusTypeDef gcc_phat_configure(uint32_t fs_hz, uint32_t frame_n, uint32_t fft_l)
+{
+    if (fs_hz == 0U || fs_hz > FS_HZ_MAX || frame_n < 2U || frame_n > FRAME_N_MAX ||
+        fft_l < 32U || fft_l > FFT_L_MAX || (fft_l & (fft_l - 1U)) != 0U || frame_n > fft_l)
+    {
+        return HAL_ERROR;
+    }
+
+    /* 初始化 FFT */
+    if (arm_rfft_fast_init_f32(&fft_inst, (uint16_t)fft_l) != ARM_MATH_SUCCESS)
+    {
+        return HAL_ERROR;
+    }
+#if GCC_PHAT_PACKED_FFT
+    cfft_inst = select_cfft(fft_l);
+#endif
+
+    cfg_fs_hz = fs_hz;
+    cfg_frame_n = frame_n;
+    cfg_fft_l = fft_l;
+    cfg_fft_base = fft_l;
+    cfg_fft_shift = 0;
+
+    /* 物理约束搜索范围与角度查找表 */
+    init_geometry();
+
+    /* 初始化汉宁窗 */
+    init_hann_window();
+
+    /* 初始化 DFT 余弦表 */
+    init_dft_table();
+
+    /* 清零缓冲区 */
+    memset(fft_work, 0, sizeof(fft_work));
+    memset(gcc_output, 0, sizeof(gcc_output));
+
+    /* 频带换算为频点，带外互功率谱清零 */
+    init_band();
+
+    /* 按频带与滞后范围，对基准长度及各可缩短长度实测选择逆变换方式 */
+    recalibrate_lag_eval();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 在 gcc_phat_configure() 的长度以下切换 FFT 长度
+ */
+HAL_StatusTypeDef gcc_phat_switch_fft_len(uint32_t fft_l)
+{
+    uint32_t old_l = cfg_fft_l;
+    uint32_t shift = 0;
+
+    while (shift < FFT_SHIFT_MAX && (cfg_fft_base >> shift) > fft_l)
+    {
+        shift++;
+    }
+    if ((cfg_fft_base >> shift) != fft_l || shift > fft_shift_limit())
+    {
+        return HAL_ERROR;
+    }
+    if (shift == cfg_fft_shift)
+    {
+        return HAL_OK;
+    }
+
+    /* 旧长度的平均谱暂存到 fft_work（下一帧预处理时重写），再按频率重采样回 cross_avg */
+    memcpy(fft_work, cross_avg, old_l * sizeof(float));
+    if (select_fft_len(shift) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    resample_spec_avg(fft_work, old_l);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 当前 FFT 长度
+ */
+uint32_t gcc_phat_get_fft_len(void)
+{
+    return cfg_fft_l;
+}
+
+/**
+ * @brief 按当前 FFT 长度截断搜索范围：不超过半个 FFT 长度
+ */
+static void limit_max_lag(void)
+{
+    cfg_max_lag = geo_max_lag;
+    if (cfg_max_lag > cfg_fft_l / 2U - 1U)
+    {
+        cfg_max_lag = cfg_fft_l / 2U - 1U;
+    }
+}
+
+/**
+ * @brief 按当前采样率与阵列几何计算搜索范围并重建角度查找表
+ *
+ * 最大滞后 floor(d/c * fs) + 1，不超过查找表容量 ANGLE_LUT_MAX_LAG，再由 limit_max_lag()
+ * 截断到半个 FFT 长度；查找表按截断前的范围建立，切换 FFT 长度时无需重建。
+ * 表项 i 对应滞后 (i - lut_half) / ANGLE_LUT_DIV，超出物理范围的滞后取 ±90 度；
+ * 查表只用于 |sin(theta)| <= ANGLE_LUT_SIN_MAX，端射方向仍用 asinf（声源很少停在该处）。
+ */
+static void init_geometry(void)
+{
+    float lag_scale = geo_sound_speed / (geo_mic_dist * (float)cfg_fs_hz); /* sin(theta) / lag */
+
+    cfg_sin_per_lag = lag_scale;
+    lut_edge = ANGLE_LUT_SIN_MAX / lag_scale * (float)ANGLE_LUT_DIV;
+
+    geo_max_lag = (uint32_t)((geo_mic_dist / geo_sound_speed) * (float)cfg_fs_hz) + 1U;
+    if (geo_max_lag > ANGLE_LUT_MAX_LAG)
+    {
+        geo_max_lag = ANGLE_LUT_MAX_LAG;
+    }
+    limit_max_lag();
+
+    /* 插值结果最多越出整数峰 1 个采样 */
+    lut_half = (geo_max_lag + 1U) * ANGLE_LUT_DIV;
+    if (lut_edge > (float)lut_half)
+    {
+        lut_edge = (float)lut_half;
+    }
+    cfg_inv_fs = 1.0f / (float)cfg_fs_hz;
+
+    for (uint32_t i = 0; i <= 2U * lut_half; i++)
+    {
+        float lag = ((float)i - (float)lut_half) / (float)ANGLE_LUT_DIV;
+        float sin_theta = lag * lag_scale;
+
+        /* clamp 到 [-1, 1] */
+        if (sin_theta > 1.0f)
+            sin_theta = 1.0f;
+        if (sin_theta < -1.0f)
+            sin_theta = -1.0f;
+
+        theta_lut[i] = asinf(sin_theta) * 180.0f / PI;
+    }
+}
+
+/**
+ * @brief 修改阵列几何
+ */
+HAL_StatusTypeDef gcc_phat_set_geometry(float mic_dist_m, float sound_speed)
+{
+    if (!(mic_dist_m > 0.0f) || !(sound_speed > 0.0f) ||
+        (uint32_t)((mic_dist_m / sound_speed) * (float)FS_HZ_MAX) + 1U > ANGLE_LUT_MAX_LAG)
+    {
+        return HAL_ERROR;
+    }
+
+    geo_mic_dist = mic_dist_m;
+    geo_sound_speed = sound_speed;
+    init_geometry();
+
+    /* 搜索范围变化后直接 DFT 的代价随之变化，重新选择 */
+    recalibrate_lag_eval();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 按当前采样率与 FFT 长度换算有效频点范围与主瓣宽度
+ */
+static void init_band_bins(void)
+{
+    uint32_t half = cfg_fft_l / 2U;
+    uint64_t lo = ((uint64_t)band_lo_hz * cfg_fft_l + cfg_fs_hz - 1U) / cfg_fs_hz; /* 向上取整 */
+    uint64_t hi = ((uint64_t)band_hi_hz * cfg_fft_l) / cfg_fs_hz;                  /* 向下取整 */
+
+    band_k_hi = (hi > half) ? half : (uint32_t)hi;
+    band_k_lo = (lo > band_k_hi) ? band_k_hi : (uint32_t)lo;
+
+    /* 上限 B 的限带相关函数第一个零点约在 fs/(2B) = fft_l/(2*k_hi) 个采样处；全频带时为 1 */
+    band_lobe = (band_k_hi > 0U) ? (int32_t)((cfg_fft_l + 2U * band_k_hi - 1U) / (2U * band_k_hi)) : 1;
+}
+
+/**
+ * @brief 由原始加权按当前缩短级数抽取并归一化
+ */
+static void load_band_weight(void)
+{
+    uint32_t half = cfg_fft_l / 2U;
+
+    for (uint32_t k = 0; k <= half; k++)
+    {
+        band_weight[k] = band_weight_raw[k << cfg_fft_shift];
+    }
+    normalize_band_weight();
+}
+
+/**
+ * @brief 按当前配置换算有效频点范围，加权复位为 1，带外互功率谱清零，平均状态复位
+ * @note 带外频点此后不再写入，IFFT 只读取 cross_spectrum，因此只需在这里
+ *       （及切换 FFT 长度时）清零
+ */
+static void init_band(void)
+{
+    init_band_bins();
+
+    for (uint32_t k = 0; k <= cfg_fft_base / 2U; k++)
+    {
+        band_weight_raw[k] = 1.0f;
+    }
+    load_band_weight();
+
+    memset(cross_spectrum, 0, sizeof(cross_spectrum));
+    gcc_phat_reset_spec_avg();
+}
+
+/**
+ * @brief 设置有效频带
+ */
+HAL_StatusTypeDef gcc_phat_set_band(uint32_t lo_hz, uint32_t hi_hz)
+{
+    if (lo_hz > hi_hz)
+    {
+        return HAL_ERROR;
+    }
+
+    band_lo_hz = lo_hz;
+    band_hi_hz = hi_hz;
+    init_band();
+
+    /* 频点数变化后直接 DFT 的代价随之变化，重新选择 */
+    recalibrate_lag_eval();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 设置互功率谱递归平均的遗忘因子
+ */
+HAL_StatusTypeDef gcc_phat_set_spec_avg(float lambda)
+{
+    if (!(lambda >= 0.0f && lambda < 1.0f))
+    {
+        return HAL_ERROR;
+    }
+
+    avg_lambda = lambda;
+    avg_gain = 1.0f - lambda;
+    gcc_phat_reset_spec_avg();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 清空互功率谱平均状态
+ */
+void gcc_phat_reset_spec_avg(void)
+{
+    memset(cross_avg, 0, sizeof(cross_avg));
+}
+
+/**
+ * @brief 读取打包格式中频点 k 的平均互功率谱
+ * @param spec arm_rfft_fast_f32 打包格式
+ * @param half 该格式的 fft_l / 2
+ */
+static void spec_bin_get(const float *spec, uint32_t k, uint32_t half, float *re, float *im)
+{
+    if (k == 0U || k == half)
+    {
+        *re = spec[(k == 0U) ? 0U : 1U];
+        *im = 0.0f;
+    }
+    else
+    {
+        *re = spec[2U * k];
+        *im = spec[2U * k + 1U];
+    }
+}
+
+/**
+ * @brief 把旧 FFT 长度下的平均互功率谱按频率重采样到当前长度，只写带内频点
+ * @param src 旧长度的 cross_avg 副本
+ * @param src_l 旧 FFT 长度（与当前长度相差 2 的幂）
+ *
+ * 零填充不改变同一频率处的频谱值：缩短时新频点 k 正好对应旧频点 k * src_l / fft_l；
+ * 加长时偶数倍位置直接取旧频点，其间的新频点按相邻两个旧频点线性插值。
+ */
+static void resample_spec_avg(const float *src, uint32_t src_l)
+{
+    uint32_t half = cfg_fft_l / 2U;
+    uint32_t src_half = src_l / 2U;
+
+    memset(cross_avg, 0, cfg_fft_l * sizeof(float));
+
+    for (uint32_t k = band_k_lo; k <= band_k_hi; k++)
+    {
+        float re, im;
+
+        if (src_l >= cfg_fft_l)
+        {
+            spec_bin_get(src, k * (src_l / cfg_fft_l), src_half, &re, &im);
+        }
+        else
+        {
+            uint32_t ratio = cfg_fft_l / src_l;
+            uint32_t j = k / ratio;
+            float frac = (float)(k % ratio) / (float)ratio;
+
+            spec_bin_get(src, j, src_half, &re, &im);
+            if (frac > 0.0f)
+            {
+                float re1, im1;
+
+                spec_bin_get(src, j + 1U, src_half, &re1, &im1);
+                re += frac * (re1 - re);
+                im += frac * (im1 - im);
+            }
+        }
+
+        if (k == 0U || k == half)
+        {
+            cross_avg[(k == 0U) ? 0U : 1U] = re;
+        }
+        else
+        {
+            cross_avg[2U * k] = re;
+            cross_avg[2U * k + 1U] = im;
+        }
+    }
+}
+
+/**
+ * @brief 当前有效频点范围
+ */
+void gcc_phat_get_band_bins(uint32_t *k_lo, uint32_t *k_hi)
+{
+    *k_lo = band_k_lo;
+    *k_hi = band_k_hi;
+}
+
+/**
+ * @brief 设置带内频点加权
+ */
+HAL_StatusTypeDef gcc_phat_set_band_weights(const float *weight, uint32_t n)
+{
+    if (cfg_fft_shift != 0U || n != band_k_hi - band_k_lo + 1U)
+    {
+        return HAL_ERROR;
+    }
+
+    memcpy(&band_weight_raw[band_k_lo], weight, n * sizeof(float));
+    load_band_weight();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief 强制指定滞后窗口求值方式，或恢复实测选择
+ */
+void gcc_phat_set_lag_eval(gcc_phat_lag_eval_t mode)
+{
+    if (mode == GCC_PHAT_LAG_AUTO)
+    {
+        lag_eval_forced = false;
+        recalibrate_lag_eval();
+    }
+    else
+    {
+        lag_eval_forced = true;
+        lag_eval = mode;
+    }
+}
+
+/**
+ * @brief 当前滞后窗口求值方式
+ */
+gcc_phat_lag_eval_t gcc_phat_get_lag_eval(void)
+{
+    return lag_eval;
+}
+
+/**
+ * @brief 预处理：去直流 + 加窗
+ * @param input 输入环 (长度 cfg_frame_n)
+ * @param start 最早采样在环中的下标
+ * @param output 按时间顺序排列的输出
+ * @param stride 输出步长（1: 实数缓冲区; 2: 复数缓冲区的实部或虚部）
+ */
+static void preprocess(const float *input, uint32_t start, float *output, uint32_t stride)
+{
+    float mean = 0.0f;
+    uint32_t head = cfg_frame_n - start;
+
+    /* 计算均值（直流分量），与顺序无关，直接遍历整个环 */
+    for (uint32_t i = 0; i < cfg_frame_n; i++)
+    {
+        mean += input[i];
+    }
+    mean /= (float)cfg_frame_n;
+
+    /* 去直流 + 乘汉宁窗，环分两段读出 */
+    for (uint32_t i = 0; i < head; i++)
+    {
+        output[i * stride] = (input[start + i] - mean) * hann_window[i];
+    }
+    for (uint32_t i = head; i < cfg_frame_n; i++)
+    {
+        output[i * stride] = (input[i - head] - mean) * hann_window[i];
+    }
+}
+
+/* PHAT 归一化的正则项：|G| 替换为 sqrt(|G|^2 + EPS_PHAT^2) */
+#define EPS_PHAT2 (EPS_PHAT * EPS_PHAT)
 
-/* FFT 工作缓冲区 - 对齐到 32 字节 */
-__attribute__((aligned(32))) static float fft_buf1[FFT_L];
+/**
+ * @brief 快速倒数平方根 1/sqrt(x)
+ *
+ * 位运算给出初值，两次牛顿迭代后相对误差约 5e-6，
+ * 代替 sqrtf + 两次除法（M7 上 VSQRT/VDIV 各 14 周期且不流水）。
+ */
+static inline float fast_rsqrt(float x)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } v = {x};
+    float y;
 
-__attribute__((aligned(32))) static float fft_buf2[FFT_L];
+    v.u = 0x5F375A86UL - (v.u >> 1);
+    y = v.f;
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y;
+}
 
-__attribute__((aligned(32))) static float cross_spectrum[FFT_L];
+/**
+ * @brief PHAT 加权后写出一个复数频点: out = w * G / |G|
+ */
+static inline void phat_store(float re, float im, float w, float *out)
+{
+    float inv = fast_rsqrt(re * re + im * im + EPS_PHAT2) * w;
 
-__attribute__((aligned(32))) static float gcc_output[FFT_L];
+    out[0] = re * inv;
+    out[1] = im * inv;
+}
 
-/* 临时预处理缓冲区 */
-static float temp_x1[FRAME_N];
-static float temp_x2[FRAME_N];
+/**
+ * @brief PHAT 加权的实数频点（直流 / Nyquist）: w * G / |G|
+ */
+static inline float phat_real(float g, float w)
+{
+    return g * fast_rsqrt(g * g + EPS_PHAT2) * w;
+}
 
 /**
- * @brief 初始化汉宁窗
+ * @brief 互功率谱频点 k 递归平均后做 PHAT 加权
+ * @param re 本帧 Re G(k)
+ * @param im 本帧 Im G(k)
+ * @param k 频点序号 (1 ~ fft_l/2 - 1)
+ * @param out 输出位置 (&result[2k])
  */
-static void init_hann_window(void)
+static inline void cross_store(float re, float im, uint32_t k, float *out)
 {
-    for (uint32_t n = 0; n < FRAME_N; n++)
+    if (avg_lambda > 0.0f)
     {
-        hann_window[n] = 0.5f * (1.0f - arm_cos_f32(2.0f * PI * (float)n / (float)(FRAME_N - 1)));
+        float *acc = &cross_avg[2U * k];
+
+        re = avg_lambda * acc[0] + avg_gain * re;
+        im = avg_lambda * acc[1] + avg_gain * im;
+        acc[0] = re;
+        acc[1] = im;
     }
+    phat_store(re, im, band_weight[k], out);
 }
 
 /**
- * @brief 初始化 GCC-PHAT 模块
+ * @brief 直流 / Nyquist 频点递归平均后做 PHAT 加权
+ * @param g 本帧 G(k)
+ * @param slot 打包格式中的位置 (0: 直流; 1: Nyquist)
+ * @param k 频点序号 (0 或 fft_l/2)
  */
-void gcc_phat_init(void)
+static inline float cross_real(float g, uint32_t slot, uint32_t k)
 {
-    /* 初始化 FFT */
-    arm_rfft_fast_init_f32(&fft_inst, FFT_L);
+    if (avg_lambda > 0.0f)
+    {
+        g = avg_lambda * cross_avg[slot] + avg_gain * g;
+        cross_avg[slot] = g;
+    }
+    return phat_real(g, band_weight[k]);
+}
 
-    /* 初始化汉宁窗 */
-    init_hann_window();
+/**
+ * @brief 由打包复数谱的一对频点求 4 * X1[k] * conj(X2[k])
+ * @param zk &Z[k]
+ * @param zn &Z[N-k]
+ */
+static inline void split_cross(const float *zk, const float *zn, float *re, float *im)
+{
+    float p = zk[0] + zn[0];
+    float q = zk[1] - zn[1];
+    float r = zk[1] + zn[1];
+    float t = zn[0] - zk[0];
 
-    /* 清零缓冲区 */
-    memset(fft_buf1, 0, sizeof(fft_buf1));
-    memset(fft_buf2, 0, sizeof(fft_buf2));
-    memset(cross_spectrum, 0, sizeof(cross_spectrum));
-    memset(gcc_output, 0, sizeof(gcc_output));
+    *re = p * r + q * t;
+    *im = q * r - p * t;
 }
 
+#if GCC_PHAT_PACKED_FFT
 /**
- * @brief 预处理：去直流 + 加窗
+ * @brief 由打包复数谱分离 X1/X2，计算带内互功率谱，递归平均后做 PHAT 加权
+ * @param z z = x1 + j*x2 的 fft_l 点复数 FFT 结果
+ * @param result 输出 w*G/|G|，G = X1 * conj(X2)（开启平均时为平均值），arm_rfft_fast_f32 打包格式
+ *               [G0, G(N/2), Re G1, Im G1, ...]，带外频点不写（保持为 0）
+ *
+ * 设 Z[k] = a + jb, Z[N-k] = c + jd，则
+ *   X1[k] = ((a + c) + j(b - d)) / 2
+ *   X2[k] = ((b + d) + j(c - a)) / 2
+ * 直流和 Nyquist 点处 X1、X2 均为实数，分别为 Z 的实部与虚部。
+ * PHAT 归一化与幅度无关，省略公共系数 1/4。
  */
-static void preprocess(const float *input, float *output)
+static void split_cross_phat(const float *z, float *result, uint32_t fft_l)
 {
-    float mean = 0.0f;
+    uint32_t half = fft_l / 2U;
+    uint32_t k = (band_k_lo > 0U) ? band_k_lo : 1U;
+    uint32_t k_end = (band_k_hi < half) ? band_k_hi : half - 1U;
 
-    /* 计算均值（直流分量） */
-    for (uint32_t i = 0; i < FRAME_N; i++)
+    /* 直流与 Nyquist 为两个独立的实数频点 */
+    if (band_k_lo == 0U)
     {
-        mean += input[i];
+        result[0] = cross_real(z[0] * z[1], 0U, 0U);
+    }
+    if (band_k_hi == half)
+    {
+        result[1] = cross_real(z[2U * half] * z[2U * half + 1U], 1U, half);
     }
-    mean /= (float)FRAME_N;
 
-    /* 去直流 + 乘汉宁窗 */
-    for (uint32_t i = 0; i < FRAME_N; i++)
+    /* 每次两个频点，给双发射 FPU 提供独立的运算链 */
+    for (; k + 1U <= k_end; k += 2U)
     {
-        output[i] = (input[i] - mean) * hann_window[i];
+        const float *zk = &z[2U * k];
+        const float *zn = &z[2U * (fft_l - k)];
+        float re0, im0, re1, im1;
+
+        split_cross(zk, zn, &re0, &im0);
+        split_cross(zk + 2, zn - 2, &re1, &im1);
+        cross_store(re0, im0, k, &result[2U * k]);
+        cross_store(re1, im1, k + 1U, &result[2U * k + 2U]);
     }
-}
 
+    for (; k <= k_end; k++)
+    {
+        float re, im;
+
+        split_cross(&z[2U * k], &z[2U * (fft_l - k)], &re, &im);
+        cross_store(re, im, k, &result[2U * k]);
+    }
+}
+#else
 /**
- * @brief 复数乘法: result = a * conj(b)
- * CMSIS-DSP 复数格式: [Re0, Im0, Re1, Im1, ...]
+ * @brief 带内互功率谱 + 递归平均 + PHAT 加权: result = w * G / |G|，G = a * conj(b)
+ * @param a X1，arm_rfft_fast_f32 打包格式 [Re0, Re(N/2), Re1, Im1, ...]
+ * @param b X2，格式同上
+ * @param result 输出，带外频点不写（保持为 0）
+ * @param len 浮点数个数 (fft_l)
  */
-static void complex_mult_conj(const float *a, const float *b, float *result, uint32_t len)
+static void cross_phat(const float *a, const float *b, float *result, uint32_t len)
 {
-    for (uint32_t i = 0; i < len; i += 2)
+    uint32_t half = len / 2U;
+    uint32_t k = (band_k_lo > 0U) ? band_k_lo : 1U;
+    uint32_t k_end = (band_k_hi < half) ? band_k_hi : half - 1U;
+
+    /* 直流与 Nyquist 为两个独立的实数频点 */
+    if (band_k_lo == 0U)
+    {
+        result[0] = cross_real(a[0] * b[0], 0U, 0U);
+    }
+    if (band_k_hi == half)
+    {
+        result[1] = cross_real(a[1] * b[1], 1U, half);
+    }
+
+    /* 每次两个频点 */
+    for (; k + 1U <= k_end; k += 2U)
+    {
+        uint32_t i = 2U * k;
+        float a0r = a[i], a0i = a[i + 1U], b0r = b[i], b0i = b[i + 1U];
+        float a1r = a[i + 2U], a1i = a[i + 3U], b1r = b[i + 2U], b1i = b[i + 3U];
+
+        cross_store(a0r * b0r + a0i * b0i, a0i * b0r - a0r * b0i, k, &result[i]);
+        cross_store(a1r * b1r + a1i * b1i, a1i * b1r - a1r * b1i, k + 1U, &result[i + 2U]);
+    }
+
+    for (; k <= k_end; k++)
     {
-        float a_re = a[i];
-        float a_im = a[i + 1];
-        float b_re = b[i];
-        float b_im = -b[i + 1]; /* 取共轭 */
+        uint32_t i = 2U * k;
 
-        result[i] = a_re * b_re - a_im * b_im;     /* 实部 */
-        result[i + 1] = a_re * b_im + a_im * b_re; /* 虚部 */
+        cross_store(a[i] * b[i] + a[i + 1U] * b[i + 1U],
+                    a[i + 1U] * b[i] - a[i] * b[i + 1U], k, &result[i]);
     }
 }
+#endif
 
 /**
- * @brief PHAT 加权
+ * @brief 直接 DFT 只计算滞后窗口 [-m_last, m_last] 内的 GCC 输出
+ * @param spec PHAT 加权后的互功率谱，arm_rfft_fast_f32 打包格式
+ * @param out 输出，与 IFFT 的循环排列一致（滞后 m 位于 m mod len），窗口外不写
+ * @param len FFT 长度
+ * @param m_last 窗口半宽：最大滞后加上插值读取的邻点数
+ *
+ * 利用共轭对称，r[m] 与 r[-m] 共用同一组累加:
+ *   A = sum Re(G_k) cos(2*pi*k*m/N), B = sum Im(G_k) sin(2*pi*k*m/N)
+ *   r[+m] = (G_0 + (-1)^m G_{N/2} + 2(A - B)) / N
+ *   r[-m] = (G_0 + (-1)^m G_{N/2} + 2(A + B)) / N
+ * 带外频点为 0，只累加有效频带 [band_k_lo, band_k_hi]。
+ * 代价约 (m_last + 1) * 2 * 带内频点数 次乘加，与一次 N 点实数 IFFT 相比孰快取决于 N 与频带宽度。
  */
-static void phat_weighting(float *spectrum, uint32_t len)
+static void lag_dft(const float *spec, float *out, uint32_t len, uint32_t m_last)
 {
-    for (uint32_t i = 0; i < len; i += 2)
+    uint32_t half = len / 2U;
+    uint32_t mask = len - 1U;
+    uint32_t tab_mask = cfg_fft_base - 1U;
+    uint32_t tab_step = cfg_fft_base / len;              /* 余弦表按基准长度建立 */
+    uint32_t sin_ofs = cfg_fft_base - cfg_fft_base / 4U; /* sin(x) = cos(x - pi/2) */
+    uint32_t m_end = (m_last < half) ? m_last : half - 1U;
+    uint32_t k_start = (band_k_lo > 0U) ? band_k_lo : 1U;
+    uint32_t k_end = (band_k_hi < half) ? band_k_hi : half - 1U;
+    float scale = 1.0f / (float)len;
+
+    for (uint32_t m = 0; m <= m_end; m++)
     {
-        float re = spectrum[i];
-        float im = spectrum[i + 1];
-        float mag = sqrtf(re * re + im * im) + EPS_PHAT;
+        float acc_c0 = 0.0f, acc_s0 = 0.0f;
+        float acc_c1 = 0.0f, acc_s1 = 0.0f;
+        uint32_t k = k_start;
+        uint32_t step = m * tab_step;
+        uint32_t idx = (k * step) & tab_mask;
 
-        spectrum[i] = re / mag;
-        spectrum[i + 1] = im / mag;
+        /* 两组独立累加器交替使用，减少 FPU 流水线依赖 */
+        for (; k + 1U <= k_end; k += 2U)
+        {
+            uint32_t idx1 = (idx + step) & tab_mask;
+
+            acc_c0 += spec[2U * k] * dft_cos[idx];
+            acc_s0 += spec[2U * k + 1U] * dft_cos[(idx + sin_ofs) & tab_mask];
+            acc_c1 += spec[2U * k + 2U] * dft_cos[idx1];
+            acc_s1 += spec[2U * k + 3U] * dft_cos[(idx1 + sin_ofs) & tab_mask];
+            idx = (idx1 + step) & tab_mask;
+        }
+        for (; k <= k_end; k++)
+        {
+            acc_c0 += spec[2U * k] * dft_cos[idx];
+            acc_s0 += spec[2U * k + 1U] * dft_cos[(idx + sin_ofs) & tab_mask];
+            idx = (idx + step) & tab_mask;
+        }
+
+        float acc_c = acc_c0 + acc_c1;
+        float acc_s = acc_s0 + acc_s1;
+        float base = spec[0] + ((m & 1U) ? -spec[1] : spec[1]);
+
+        out[m] = (base + 2.0f * (acc_c - acc_s)) * scale;
+        out[(len - m) & mask] = (base + 2.0f * (acc_c + acc_s)) * scale;
     }
 }
 
 /**
- * @brief FFT shift：将零延迟移到中心
+ * @brief 由互功率谱求 GCC 输出（循环排列，负滞后位于末尾）
+ * @param mode 求值方式
+ * @param out 输出，长度 cfg_fft_l
+ * @note arm_rfft_fast_f32 逆变换只读取 cross_spectrum，带外零值得以保留
  */
-static void fftshift(float *data, uint32_t len)
+static void eval_lags(gcc_phat_lag_eval_t mode, float *out)
 {
-    uint32_t half = len / 2;
-    float temp;
+    if (mode == GCC_PHAT_LAG_DFT)
+    {
+        /* 抛物线 / 高斯 / 相位斜率只读取峰值两侧各 1 点，sinc 读取 SINC_HALF 点 */
+        uint32_t margin = (interp_mode == GCC_PHAT_INTERP_SINC) ? (uint32_t)SINC_HALF : 1U;
 
-    for (uint32_t i = 0; i < half; i++)
+        lag_dft(cross_spectrum, out, cfg_fft_l, cfg_max_lag + margin);
+    }
+    else
     {
-        temp = data[i];
-        data[i] = data[i + half];
-        data[i + half] = temp;
+        arm_rfft_fast_f32(&fft_inst, cross_spectrum, out, 1);
     }
 }
 
+/* 实测选择时每种方式的重复次数，取最小值 */
+#define LAG_EVAL_CAL_RUNS 3U
+
+/* 直接 DFT 需比完整 IFFT 快出此比例 (%) 才选用，两者接近时固定为 IFFT，避免每次实测结果来回翻转 */
+#define LAG_EVAL_DFT_MARGIN_PCT 10U
+
 /**
- * @brief 在物理约束范围内寻找峰值
- * @param data GCC 输出（已 fftshift）
- * @param len 数据长度
- * @param peak_idx 输出峰值索引
- * @param peak_val 输出峰值
- * @param second_peak 输出次峰值
+ * @brief 分别计时两种求值方式，返回较快者
+ * @note 需要 DWT 周期计数器已使能，否则保持完整 IFFT。
+ *       读取 cross_spectrum 的当前内容（select_fft_len() 切换长度后为零），耗时与数值无关；
+ *       输出写入 fft_work 的后半（每帧预处理时重写），不改动 gcc_output，
+ *       gcc_phat_find_peaks() 仍可读取上一帧的结果
  */
-static void find_peak_constrained(const float *data, uint32_t len,
-                                  int32_t *peak_idx, float *peak_val, float *second_peak)
+static gcc_phat_lag_eval_t calibrate_lag_eval(void)
 {
-    int32_t center = (int32_t)(len / 2);
-    int32_t search_start = center - (int32_t)MAX_LAG_SAMPLES;
-    int32_t search_end = center + (int32_t)MAX_LAG_SAMPLES;
-
-    /* 边界检查 */
-    if (search_start < 0)
-        search_start = 0;
-    if (search_end >= (int32_t)len)
-        search_end = (int32_t)len - 1;
+    uint32_t best[2] = {UINT32_MAX, UINT32_MAX};
 
-    *peak_val = -1e10f;
-    *second_peak = -1e10f;
-    *peak_idx = center;
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+    {
+        return GCC_PHAT_LAG_IFFT;
+    }
 
-    /* 寻找峰值 */
-    for (int32_t i = search_start; i <= search_end; i++)
+    for (uint32_t r = 0; r < LAG_EVAL_CAL_RUNS; r++)
     {
-        float val = fabsf(data[i]);
-        if (val > *peak_val)
-        {
-            *second_peak = *peak_val;
-            *peak_val = val;
-            *peak_idx = i;
-        }
-        else if (val > *second_peak)
+        for (uint32_t mode = 0; mode < 2U; mode++)
         {
-            *second_peak = val;
+            uint32_t t0 = DWT->CYCCNT;
+
+            eval_lags((gcc_phat_lag_eval_t)mode, &fft_work[FFT_L_MAX]);
+            t0 = DWT->CYCCNT - t0;
+            if (t0 < best[mode])
+            {
+                best[mode] = t0;
+            }
         }
     }
+
+    return ((uint64_t)best[GCC_PHAT_LAG_DFT] * 100U <
+            (uint64_t)best[GCC_PHAT_LAG_IFFT] * (100U - LAG_EVAL_DFT_MARGIN_PCT))
+               ? GCC_PHAT_LAG_DFT
+               : GCC_PHAT_LAG_IFFT;
 }
 
 /**
- * @brief 三点抛物线插值求亚采样延迟
+ * @brief 未强制指定时，对基准长度及各可缩短长度重新实测选择求值方式
+ * @note 逐个切换到各长度实测，结果缓存在 lag_eval_len[]，最后回到当前长度；
+ *       gcc_phat_switch_fft_len() 运行中切换时直接取用，不再实测
  */
-static float parabolic_interp(const float *data, int32_t peak_idx, uint32_t len)
+static void recalibrate_lag_eval(void)
 {
-    if (peak_idx <= 0 || peak_idx >= (int32_t)(len - 1))
+    uint32_t shift = cfg_fft_shift;
+
+    if (lag_eval_forced)
     {
-        return (float)peak_idx;
+        return;
     }
 
-    float y0 = fabsf(data[peak_idx - 1]);
-    float y1 = fabsf(data[peak_idx]);
-    float y2 = fabsf(data[peak_idx + 1]);
+    for (uint32_t s = 0; s <= fft_shift_limit(); s++)
+    {
+        lag_eval_len[s] = (select_fft_len(s) == HAL_OK) ? calibrate_lag_eval() : GCC_PHAT_LAG_IFFT;
+    }
+    (void)select_fft_len(shift);
+}
+
+/**
+ * @brief 三点抛物线插值求亚采样延迟
+ * @param data GCC 输出（循环排列）
+ * @param peak_lag 峰值整数滞后
+ * @param len 数据长度（2 的幂）
+ * @retval 亚采样精度滞后
+ */
+static float parabolic_interp(const float *data, int32_t peak_lag, uint32_t len)
+{
+    uint32_t mask = len - 1U;
 
-    float denom = 2.0f * (2.0f * y1 - y0 - y2);
+    float y0 = fabsf(data[(uint32_t)(peak_lag - 1) & mask]);
+    float y1 = fabsf(data[(uint32_t)peak_lag & mask]);
+    float y2 = fabsf(data[(uint32_t)(peak_lag + 1) & mask]);
+
+    /* 顶点偏移 (y0 - y2) / (2 * (y0 - 2*y1 + y2))，峰值偏向较大的邻点 */
+    float denom = 2.0f * (y0 - 2.0f * y1 + y2);
     if (fabsf(denom) < 1e-10f)
     {
-        return (float)peak_idx;
+        return (float)peak_lag;
     }
 
     float delta = (y0 - y2) / denom;
@@ -198,13 +1041,375 @@ static float parabolic_interp(const float *data, int32_t peak_idx, uint32_t len)
     if (delta < -0.5f)
         delta = -0.5f;
 
-    return (float)peak_idx + delta;
+    return (float)peak_lag + delta;
+}
+
+/**
+ * @brief 三点高斯插值：对 ln|r| 做抛物线拟合
+ * @note 主瓣近似高斯形状时无偏差；任一点不为正时退回抛物线插值
+ */
+static float gaussian_interp(const float *data, int32_t peak_lag, uint32_t len)
+{
+    uint32_t mask = len - 1U;
+
+    float y0 = fabsf(data[(uint32_t)(peak_lag - 1) & mask]);
+    float y1 = fabsf(data[(uint32_t)peak_lag & mask]);
+    float y2 = fabsf(data[(uint32_t)(peak_lag + 1) & mask]);
+
+    if (y0 <= 0.0f || y2 <= 0.0f)
+    {
+        return parabolic_interp(data, peak_lag, len);
+    }
+
+    float l0 = logf(y0);
+    float l1 = logf(y1);
+    float l2 = logf(y2);
+
+    float denom = 2.0f * (l0 - 2.0f * l1 + l2);
+    if (fabsf(denom) < 1e-10f)
+    {
+        return (float)peak_lag;
+    }
+
+    float delta = (l0 - l2) / denom;
+
+    if (delta > 0.5f)
+        delta = 0.5f;
+    if (delta < -0.5f)
+        delta = -0.5f;
+
+    return (float)peak_lag + delta;
+}
+
+/**
+ * @brief 加窗 sinc 重建 r(peak_lag + u)
+ * @param u 相对整数峰的偏移 (|u| <= 0.5)
+ *
+ * r(p + u) = sum_n r[p + n] * sinc(u - n) * w(u - n), n = -SINC_HALF .. SINC_HALF
+ * （抽头关于整数峰对称，不对称截断会使极值位置产生偏差）
+ * sin(pi*(u - n)) = (-1)^n sin(pi*u)，每次重建只需一次正弦；
+ * 窗 w(x) = (1 - (x / (SINC_HALF + 1))^2)^2 为多项式，无需三角函数。
+ */
+static float sinc_eval(const float *data, int32_t peak_lag, float u, uint32_t len)
+{
+    uint32_t mask = len - 1U;
+    float s = arm_sin_f32(PI * u);
+    float acc = 0.0f;
+
+    if (fabsf(u) < 1e-6f)
+    {
+        return data[(uint32_t)peak_lag & mask];
+    }
+
+    for (int32_t n = -SINC_HALF; n <= SINC_HALF; n++)
+    {
+        float x = u - (float)n;
+        float t = x * (1.0f / (float)(SINC_HALF + 1));
+        float w = (1.0f - t * t) * (1.0f - t * t);
+        float sn = (n & 1) ? -s : s;
+
+        acc += data[(uint32_t)(peak_lag + n) & mask] * sn * w / (PI * x);
+    }
+    return acc;
+}
+
+/* sinc 细化的迭代次数（步长逐次减半） */
+#define SINC_REFINE_ITERS 3U
+
+/**
+ * @brief 加窗 sinc 插值细化：从抛物线估计出发，在重建的连续相关函数上逐次缩小步长找极值
+ * @note 限带相关函数过采样，sinc 重建接近理想插值；需要峰值两侧各 SINC_HALF 点有效
+ */
+static float sinc_interp(const float *data, int32_t peak_lag, uint32_t len)
+{
+    float sign = (data[(uint32_t)peak_lag & (len - 1U)] < 0.0f) ? -1.0f : 1.0f;
+    float u = parabolic_interp(data, peak_lag, len) - (float)peak_lag;
+    float h = 0.25f;
+
+    for (uint32_t it = 0; it < SINC_REFINE_ITERS; it++, h *= 0.5f)
+    {
+        float fm = sign * sinc_eval(data, peak_lag, u - h, len);
+        float f0 = sign * sinc_eval(data, peak_lag, u, len);
+        float fp = sign * sinc_eval(data, peak_lag, u + h, len);
+        float denom = fm - 2.0f * f0 + fp;
+
+        if (denom < -1e-12f)
+        {
+            float d = 0.5f * h * (fm - fp) / denom;
+
+            if (d > h)
+                d = h;
+            if (d < -h)
+                d = -h;
+            u += d;
+        }
+    }
+
+    if (u > 0.5f)
+        u = 0.5f;
+    if (u < -0.5f)
+        u = -0.5f;
+
+    return (float)peak_lag + u;
+}
+
+/* 相位斜率拟合的迭代次数 */
+#define SLOPE_REFINE_ITERS 2U
+
+/**
+ * @brief 互功率谱相位斜率加权最小二乘拟合
+ * @param peak_lag 整数峰，作为相位展开的起点
+ * @retval 亚采样精度滞后
+ *
+ * 设 H_k = G_k * exp(j*w_k*tau)，w_k = 2*pi*k/N，残余时延 d 使相位 phi_k ≈ -w_k*d。
+ * 以 Re(H_k) 为权、Im(H_k) ≈ Re(H_k)*phi_k 线性化，加权最小二乘解为
+ *   d = -sum(w_k * Im H_k) / sum(w_k^2 * Re H_k)
+ * 这同时是对连续相关函数 r(tau) 的一步牛顿迭代。整数部分的旋转查 dft_cos 表，
+ * 小数部分用相量递推，每次迭代每个带内频点约 10 次乘加，不需要 atan2。
+ * 直接使用 cross_spectrum（逆变换只读取），与滞后窗口的求值方式无关。
+ */
+static float phase_slope_interp(int32_t peak_lag)
+{
+    uint32_t half = cfg_fft_l / 2U;
+    uint32_t tab_mask = cfg_fft_base - 1U;
+    uint32_t tab_step = cfg_fft_base / cfg_fft_l;        /* 余弦表按基准长度建立，同 lag_dft() */
+    uint32_t sin_ofs = cfg_fft_base - cfg_fft_base / 4U; /* sin(x) = cos(x - pi/2) */
+    uint32_t k_start = (band_k_lo > 0U) ? band_k_lo : 1U;
+    uint32_t k_end = (band_k_hi < half) ? band_k_hi : half - 1U;
+    uint32_t step = ((uint32_t)peak_lag * tab_step) & tab_mask;
+    float w0 = 2.0f * PI / (float)cfg_fft_l;
+    float u = 0.0f;
+
+    for (uint32_t it = 0; it < SLOPE_REFINE_ITERS; it++)
+    {
+        /* 小数部分的相量 exp(j*w_k*u)，从 k_start 起逐频点递推 */
+        float dr = arm_cos_f32(w0 * u);
+        float di = arm_sin_f32(w0 * u);
+        float pr = arm_cos_f32(w0 * u * (float)k_start);
+        float pi = arm_sin_f32(w0 * u * (float)k_start);
+        uint32_t idx = (k_start * step) & tab_mask;
+        float num = 0.0f;
+        float den = 0.0f;
+
+        for (uint32_t k = k_start; k <= k_end; k++)
+        {
+            const float *g = &cross_spectrum[2U * k];
+            float c = dft_cos[idx];
+            float sn = dft_cos[(idx + sin_ofs) & tab_mask];
+            float ar = g[0] * c - g[1] * sn; /* G_k * exp(j*w_k*p) */
+            float ai = g[0] * sn + g[1] * c;
+            float hr = ar * pr - ai * pi;    /* 再乘 exp(j*w_k*u) */
+            float hi = ar * pi + ai * pr;
+            float kf = (float)k;
+            float t = pr * dr - pi * di;
+
+            num += kf * hi;
+            den += kf * kf * hr;
+
+            pi = pr * di + pi * dr;
+            pr = t;
+            idx = (idx + step) & tab_mask;
+        }
+
+        if (den <= 0.0f)
+        {
+            return parabolic_interp(gcc_output, peak_lag, cfg_fft_l); /* 不是极大值，放弃拟合 */
+        }
+
+        u -= num / (w0 * den);
+        if (u > 1.0f)
+            u = 1.0f;
+        if (u < -1.0f)
+            u = -1.0f;
+    }
+
+    return (float)peak_lag + u;
+}
+
+/**
+ * @brief 按当前插值方式求亚采样精度滞后
+ */
+static float interp_lag(int32_t peak_lag)
+{
+    switch (interp_mode)
+    {
+    case GCC_PHAT_INTERP_GAUSSIAN:
+        return gaussian_interp(gcc_output, peak_lag, cfg_fft_l);
+    case GCC_PHAT_INTERP_SINC:
+        return sinc_interp(gcc_output, peak_lag, cfg_fft_l);
+    case GCC_PHAT_INTERP_PHASE_SLOPE:
+        return phase_slope_interp(peak_lag);
+    default:
+        return parabolic_interp(gcc_output, peak_lag, cfg_fft_l);
+    }
+}
+
+/**
+ * @brief 设置亚采样插值方式
+ */
+void gcc_phat_set_interp(gcc_phat_interp_t mode)
+{
+    interp_mode = mode;
+
+    /* sinc 方式改变直接 DFT 的滞后窗口宽度，重新选择 */
+    recalibrate_lag_eval();
+}
+
+/**
+ * @brief 切换亚采样插值方式，不重新实测
+ */
+void gcc_phat_switch_interp(gcc_phat_interp_t mode)
+{
+    interp_mode = mode;
+}
+
+/**
+ * @brief 当前亚采样插值方式
+ */
+gcc_phat_interp_t gcc_phat_get_interp(void)
+{
+    return interp_mode;
+}
+
+/**
+ * @brief 由滞后计算时间差与角度
+ * @param lag 亚采样精度滞后（采样点）
+ * @param dt 输出时间差 (s)
+ * @retval 角度 (度)
+ */
+static float lag_to_theta(float lag, float *dt)
+{
+    *dt = lag * cfg_inv_fs;
+    return gcc_phat_lag_to_theta(lag);
+}
+
+/**
+ * @brief 查表求滞后对应的角度
+ */
+float gcc_phat_lag_to_theta(float lag)
+{
+    float u = lag * (float)ANGLE_LUT_DIV;
+
+    /* 端射方向及超出物理范围：直接计算并限幅 */
+    if (u > lut_edge || u < -lut_edge)
+    {
+        float sin_theta = lag * cfg_sin_per_lag;
+
+        if (sin_theta > 1.0f)
+            sin_theta = 1.0f;
+        if (sin_theta < -1.0f)
+            sin_theta = -1.0f;
+
+        return asinf(sin_theta) * 180.0f / PI;
+    }
+
+    float x = u + (float)lut_half;
+    uint32_t i = (uint32_t)x;
+    float frac = x - (float)i;
+
+    if (i >= 2U * lut_half)
+    {
+        return theta_lut[2U * lut_half];
+    }
+
+    return theta_lut[i] + frac * (theta_lut[i + 1U] - theta_lut[i]);
+}
+
+/**
+ * @brief 在物理约束范围内按高度提取前 k_max 个局部极大值
+ * @param lags 输出整数滞后，按高度降序
+ * @param heights 输出峰高 |r(lag)|
+ * @param k_max 最多提取的峰数 (<= GCC_PHAT_PEAKS_MAX)
+ * @retval 实际提取的峰数
+ *
+ * 只做整数滞后搜索，亚采样插值与角度换算由调用者按需对选中的峰进行。
+ * 局部极大值: |r[lag]| > |r[lag-1]| 且 >= |r[lag+1]|（平台只取左端），
+ * 邻点可位于搜索范围之外（GCC 输出在 ±(max_lag+1) 内总是有效）。
+ * 非极大值抑制: 已选峰两侧 band_lobe 以内的极大值视为同一主瓣，不再选取。
+ * 搜索范围只有 2*max_lag+1 个滞后，逐峰重新扫描即可，无需额外缓冲区。
+ */
+static uint32_t find_peaks(int32_t *lags, float *heights, uint32_t k_max)
+{
+    uint32_t mask = cfg_fft_l - 1U;
+    int32_t max_lag = (int32_t)cfg_max_lag;
+    uint32_t n = 0;
+
+    while (n < k_max)
+    {
+        int32_t best_lag = 0;
+        float best = -1.0f;
+
+        /* 负滞后回绕到缓冲区末尾 */
+        for (int32_t lag = -max_lag; lag <= max_lag; lag++)
+        {
+            float val = fabsf(gcc_output[(uint32_t)lag & mask]);
+            bool keep = (val > best) &&
+                        (val > fabsf(gcc_output[(uint32_t)(lag - 1) & mask])) &&
+                        (val >= fabsf(gcc_output[(uint32_t)(lag + 1) & mask]));
+
+            for (uint32_t i = 0; keep && i < n; i++)
+            {
+                int32_t dist = (lag > lags[i]) ? lag - lags[i] : lags[i] - lag;
+                keep = (dist >= band_lobe);
+            }
+
+            if (keep)
+            {
+                best = val;
+                best_lag = lag;
+            }
+        }
+
+        if (best < 0.0f)
+        {
+            break; /* 没有更多极大值 */
+        }
+
+        lags[n] = best_lag;
+        heights[n] = best;
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * @brief 提取最近一次处理结果中的前 k_max 个峰，并逐峰插值
+ */
+uint32_t gcc_phat_find_peaks(gcc_phat_peak_t *peaks, uint32_t k_max)
+{
+    int32_t lags[GCC_PHAT_PEAKS_MAX];
+    float heights[GCC_PHAT_PEAKS_MAX];
+    uint32_t n;
+
+    if (k_max > GCC_PHAT_PEAKS_MAX)
+    {
+        k_max = GCC_PHAT_PEAKS_MAX;
+    }
+
+    n = find_peaks(lags, heights, k_max);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        peaks[i].height = heights[i];
+        peaks[i].lag_sub = interp_lag(lags[i]);
+        peaks[i].theta_deg = lag_to_theta(peaks[i].lag_sub, &peaks[i].dt);
+    }
+
+    return n;
 }
 
 /**
  * @brief 执行 GCC-PHAT
  */
 void gcc_phat_process(const float *x1, const float *x2, gcc_phat_result_t *result)
+{
+    gcc_phat_process_ring(x1, x2, 0, result);
+}
+
+/**
+ * @brief 对环形缓冲区中的分析窗执行 GCC-PHAT
+ */
+void gcc_phat_process_ring(const float *x1, const float *x2, uint32_t start, gcc_phat_result_t *result)
 {
     /* 初始化结果 */
     result->valid = false;
@@ -214,45 +1419,73 @@ void gcc_phat_process(const float *x1, const float *x2, gcc_phat_result_t *resul
     result->peak = 0.0f;
     result->ratio = 0.0f;
 
-    /* 1. 预处理：去直流 + 加窗 */
-    preprocess(x1, temp_x1);
-    preprocess(x2, temp_x2);
+#if GCC_PHAT_PACKED_FFT
+    /* 1. 预处理：x1 写入实部、x2 写入虚部 */
+    PROFILE_BEGIN(PROF_PREPROCESS);
+    preprocess(x1, start, &fft_work[0], 2U);
+    preprocess(x2, start, &fft_work[1], 2U);
+
+    /* 2. 零填充到 FFT_L：arm_cfft_f32 原地计算，每帧需重新清零填充段 */
+    memset(&fft_work[2U * cfg_frame_n], 0, 2U * (cfg_fft_l - cfg_frame_n) * sizeof(float));
+    PROFILE_END(PROF_PREPROCESS);
 
-    /* 2. 零填充到 FFT_L */
-    memset(fft_buf1, 0, sizeof(fft_buf1));
-    memset(fft_buf2, 0, sizeof(fft_buf2));
-    memcpy(fft_buf1, temp_x1, FRAME_N * sizeof(float));
-    memcpy(fft_buf2, temp_x2, FRAME_N * sizeof(float));
+    /* 3. 一次复数 FFT 同时得到两路频谱 */
+    PROFILE_BEGIN(PROF_FFT);
+    arm_cfft_f32(cfft_inst, fft_work, 0, 1);
+    PROFILE_END(PROF_FFT);
 
-    /* 3. FFT */
-    arm_rfft_fast_f32(&fft_inst, fft_buf1, cross_spectrum, 0); /* 暂存到 cross_spectrum */
-    memcpy(fft_buf1, cross_spectrum, FFT_L * sizeof(float));   /* 复制回 fft_buf1 */
+    /* 4. 共轭对称分离 + 带内互功率谱 G(k) = X1(k) * conj(X2(k)) + 递归平均 + PHAT 加权 */
+    PROFILE_BEGIN(PROF_CROSS_PHAT);
+    split_cross_phat(fft_work, cross_spectrum, cfg_fft_l);
+    PROFILE_END(PROF_CROSS_PHAT);
+#else
+    /* 1. 预处理：去直流 + 加窗，直接写入 FFT 输入缓冲区 */
+    PROFILE_BEGIN(PROF_PREPROCESS);
+    preprocess(x1, start, fft_buf1, 1U);
+    preprocess(x2, start, fft_buf2, 1U);
 
-    arm_rfft_fast_f32(&fft_inst, fft_buf2, cross_spectrum, 0); /* X2 的 FFT */
-    memcpy(fft_buf2, cross_spectrum, FFT_L * sizeof(float));   /* 复制回 fft_buf2 */
+    /* 2. 零填充到 FFT_L：arm_rfft_fast_f32 把输入缓冲区用作工作区，
+     *    每帧只需重新清零 [frame_n, fft_l) 的填充段 */
+    memset(&fft_buf1[cfg_frame_n], 0, (cfg_fft_l - cfg_frame_n) * sizeof(float));
+    memset(&fft_buf2[cfg_frame_n], 0, (cfg_fft_l - cfg_frame_n) * sizeof(float));
+    PROFILE_END(PROF_PREPROCESS);
 
-    /* 4. 互功率谱: G(k) = X1(k) * conj(X2(k)) */
-    complex_mult_conj(fft_buf1, fft_buf2, cross_spectrum, FFT_L);
+    /* 3. FFT：gcc_output 在逆变换前空闲，暂存 X1；cross_spectrum 的带外零值不能被覆盖 */
+    PROFILE_BEGIN(PROF_FFT);
+    arm_rfft_fast_f32(&fft_inst, fft_buf1, gcc_output, 0); /* X1 -> gcc_output */
+    arm_rfft_fast_f32(&fft_inst, fft_buf2, fft_buf1, 0);   /* X2 -> fft_buf1（输入已用完） */
+    PROFILE_END(PROF_FFT);
 
-    /* 5. PHAT 加权 */
-    phat_weighting(cross_spectrum, FFT_L);
+    /* 4. 带内互功率谱 G(k) = X1(k) * conj(X2(k)) + 递归平均 + PHAT 加权 */
+    PROFILE_BEGIN(PROF_CROSS_PHAT);
+    cross_phat(gcc_output, fft_buf1, cross_spectrum, cfg_fft_l);
+    PROFILE_END(PROF_CROSS_PHAT);
+#endif
 
-    /* 6. IFFT */
-    arm_rfft_fast_f32(&fft_inst, cross_spectrum, gcc_output, 1);
+    /* 5. IFFT，或只对滞后窗口直接 DFT（输出保持循环排列，不做 fftshift） */
+    PROFILE_BEGIN(PROF_LAG_EVAL);
+    eval_lags(lag_eval, gcc_output);
+    PROFILE_END(PROF_LAG_EVAL);
 
-    /* 7. FFT shift */
-    fftshift(gcc_output, FFT_L);
+    /* 6. 峰值搜索（物理约束）：主峰与主瓣之外的次峰，只取整数滞后与峰高 */
+    int32_t lags[2];
+    float heights[2];
+    PROFILE_BEGIN(PROF_PEAK);
+    uint32_t n_peaks = find_peaks(lags, heights, 2U);
+    PROFILE_END(PROF_PEAK);
+
+    if (n_peaks == 0U)
+    {
+        return; /* 范围内没有极大值 */
+    }
 
-    /* 8. 峰值搜索（物理约束） */
-    int32_t peak_idx;
-    float peak_val, second_peak;
-    find_peak_constrained(gcc_output, FFT_L, &peak_idx, &peak_val, &second_peak);
+    float second_peak = (n_peaks > 1U) ? heights[1] : 0.0f;
 
-    result->peak = peak_val;
-    result->ratio = peak_val / (second_peak + EPS_PHAT);
+    result->peak = heights[0];
+    result->ratio = heights[0] / (second_peak + EPS_PHAT);
 
-    /* 9. 可信度判决 */
-    if (peak_val < PEAK_MIN)
+    /* 7. 可信度判决 */
+    if (result->peak < PEAK_MIN)
     {
         return; /* 峰值太小，放弃 */
     }
@@ -262,25 +1495,75 @@ void gcc_phat_process(const float *x1, const float *x2, gcc_phat_result_t *resul
         return; /* 主峰/次峰比太小，放弃 */
     }
 
-    /* 10. 亚采样插值 */
-    float sub_idx = parabolic_interp(gcc_output, peak_idx, FFT_L);
+    /* 8. 判决通过后才对主峰做亚采样插值、时间差与角度换算 */
+    PROFILE_BEGIN(PROF_INTERP);
+    result->lag_sub = interp_lag(lags[0]);
+    result->theta_deg = lag_to_theta(result->lag_sub, &result->dt);
+    PROFILE_END(PROF_INTERP);
+    result->valid = true;
+}
+
+/**
+ * @brief 同一帧分别经两路 arm_rfft_fast_f32 与打包复数 FFT 求 X1 * conj(X2)，返回相对误差
+ */
+float gcc_phat_packed_fft_error(const float *x1, const float *x2, float *work)
+{
+    uint32_t n = cfg_fft_l;
+    uint32_t half = n / 2U;
+    const float *a = &work[2U * n]; /* X1 */
+    const float *b = &work[3U * n]; /* X2 */
+    const float *z = &work[0];      /* 打包谱 */
+    float err = 0.0f;
+    float mag = 0.0f;
 
-    /* 转换为相对于中心的延迟 */
-    float lag = sub_idx - (float)(FFT_L / 2);
-    result->lag_sub = lag;
+    /* 两路实数 FFT：输入缓冲区被用作工作区，输出写到后半 */
+    preprocess(x1, 0U, &work[0], 1U);
+    preprocess(x2, 0U, &work[n], 1U);
+    memset(&work[cfg_frame_n], 0, (n - cfg_frame_n) * sizeof(float));
+    memset(&work[n + cfg_frame_n], 0, (n - cfg_frame_n) * sizeof(float));
+    arm_rfft_fast_f32(&fft_inst, &work[0], &work[2U * n], 0);
+    arm_rfft_fast_f32(&fft_inst, &work[n], &work[3U * n], 0);
 
-    /* 11. 计算时间差 */
-    result->dt = lag / (float)FS_HZ;
+    /* 打包：x1 实部、x2 虚部，一次复数 FFT */
+    preprocess(x1, 0U, &work[0], 2U);
+    preprocess(x2, 0U, &work[1], 2U);
+    memset(&work[2U * cfg_frame_n], 0, 2U * (n - cfg_frame_n) * sizeof(float));
+    arm_cfft_f32(select_cfft(n), work, 0, 1);
 
-    /* 12. 计算角度 */
-    float sin_theta = (SOUND_SPEED * result->dt) / MIC_DIST_M;
+    for (uint32_t k = 0; k <= half; k++)
+    {
+        float ref_re, ref_im, pk_re, pk_im;
 
-    /* clamp 到 [-1, 1] */
-    if (sin_theta > 1.0f)
-        sin_theta = 1.0f;
-    if (sin_theta < -1.0f)
-        sin_theta = -1.0f;
+        if (k == 0U || k == half)
+        {
+            /* 直流 / Nyquist：两路均为实数，打包谱中分别为实部与虚部 */
+            uint32_t slot = (k == 0U) ? 0U : 1U;
 
-    result->theta_deg = asinf(sin_theta) * 180.0f / PI;
-    result->valid = true;
+            ref_re = a[slot] * b[slot];
+            ref_im = 0.0f;
+            pk_re = z[2U * k] * z[2U * k + 1U];
+            pk_im = 0.0f;
+        }
+        else
+        {
+            ref_re = a[2U * k] * b[2U * k] + a[2U * k + 1U] * b[2U * k + 1U];
+            ref_im = a[2U * k + 1U] * b[2U * k] - a[2U * k] * b[2U * k + 1U];
+            split_cross(&z[2U * k], &z[2U * (n - k)], &pk_re, &pk_im);
+            pk_re *= 0.25f;
+            pk_im *= 0.25f;
+        }
+
+        float d = sqrtf((ref_re - pk_re) * (ref_re - pk_re) + (ref_im - pk_im) * (ref_im - pk_im));
+        float m = sqrtf(ref_re * ref_re + ref_im * ref_im);
+        if (d > err)
+        {
+            err = d;
+        }
+        if (m > mag)
+        {
+            mag = m;
+        }
+    }
+
+    return (mag > 0.0f) ? err / mag : err;
 }
@@ -5,6 +5,10 @@
 #include "Servo.h"
 #include "adc_dma.h"
 #include "app_doa.h"
+#include "dsp_bench.h"
+#include "pcm_capture.h"
+#include "telemetry.h"
+#include "profile.h"
 #include "config.h"
 #include <stdio.h>
 
@@ -22,18 +26,51 @@ int main(void)
   MX_ADC1_Init();
   MX_TIM1_Init();
 
+#if DSP_BENCH_ENABLE
+  (void)dsp_bench_run();
+#endif
+
+#if PCM_CAPTURE_ENABLE
+  /* 原始 PCM 采集模式：切换波特率后串口只输出二进制帧 */
+  printf("PCM capture: FS=%dHz, FRAME=%d, BAUD=%d\r\n",
+         FS_HZ, FRAME_N, PCM_CAPTURE_BAUD);
+  if (pcm_capture_init() != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  while (1)
+  {
+    pcm_capture_poll();
+  }
+#endif
+
   /* 初始化 DOA 系统 */
   if (app_doa_init() != HAL_OK)
   {
     printf("DOA init failed!\r\n");
+    USART1_TxFlush(); /* Error_Handler 关中断，先等发送环发完 */
     Error_Handler();
   }
 
-  printf("DOA system started. FS=%dHz, FRAME=%d, FFT=%d\r\n",
-         FS_HZ, FRAME_N, FFT_L);
+  printf("DOA system started. FS=%dHz, FRAME=%d, HOP=%d, FFT=%d\r\n",
+         FS_HZ, FRAME_N, FRAME_N / FRAME_HOP_DIV, FFT_L);
+
+#if TELEMETRY_ENABLE
+  /* 之后串口只输出二进制遥测帧 */
+  if (telemetry_init() != HAL_OK)
+  {
+    Error_Handler();
+  }
+#endif
 
   while (1)
   {
+#if PROFILE_ENABLE
+    /* 串口命令：'p' 输出分段耗时统计，'r' 清零 */
+    profile_poll();
+#endif
+
     /* 检查是否有新帧可处理 */
     if (app_doa_frame_ready())
     {
@@ -43,12 +80,14 @@ int main(void)
       /* 更新舵机 */
       app_doa_servo_update();
 
-      /* 定期打印调试信息 */
+      /* 定期打印调试信息（遥测模式下每次估计已由 app_doa_process_frame 输出） */
       print_counter++;
       if (print_counter >= PRINT_INTERVAL)
       {
         print_counter = 0;
+#if !TELEMETRY_ENABLE
         app_doa_debug_print();
+#endif
         HAL_GPIO_TogglePin(GPIOH, GPIO_PIN_7);
       }
     }
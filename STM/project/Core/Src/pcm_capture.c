@@ -0,0 +1,110 @@
+/**
+ * @file pcm_capture.c
+ * @brief 原始 PCM 采集模块实现
+ *
+ * 每帧分两次 DMA 发送：先发 .dma_d2 中的帧头，完成中断里再直接从
+ * DMA 槽位发出采样数据（零拷贝）。槽位在整帧发完之前保持 acquire 状态，
+ * 串口跟不上时由 audio_frame 环形缓冲区丢帧，丢帧体现为帧头序号不连续。
+ */
+#include "pcm_capture.h"
+#include "audio_frame.h"
+#include "USART.h"
+
+/* 发送状态 */
+typedef enum
+{
+    PCM_TX_IDLE = 0, /* 无帧在发送 */
+    PCM_TX_HEADER,   /* 正在发送帧头 */
+    PCM_TX_PAYLOAD,  /* 正在发送采样数据 */
+    PCM_TX_DONE      /* 整帧发送完成，等待主循环释放槽位 */
+} pcm_tx_state_t;
+
+/* 帧头需位于 DMA1 可访问的不可缓存区域 */
+__attribute__((section(".dma_d2"), aligned(32))) static pcm_capture_header_t tx_header;
+
+static volatile pcm_tx_state_t tx_state = PCM_TX_IDLE;
+static const uint16_t *tx_payload = NULL;
+static uint16_t tx_payload_len = 0;
+
+/**
+ * @brief 初始化采集模式
+ */
+HAL_StatusTypeDef pcm_capture_init(void)
+{
+    tx_state = PCM_TX_IDLE;
+
+    /* 等启动信息经发送环发完后再切换波特率 */
+    USART1_TxFlush();
+    if (USART1_SetBaudRate(PCM_CAPTURE_BAUD) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    return audio_frame_init();
+}
+
+/**
+ * @brief 主循环轮询
+ */
+void pcm_capture_poll(void)
+{
+    uint32_t seq;
+    uint32_t frame_n;
+    const uint16_t *src;
+
+    if (tx_state == PCM_TX_DONE)
+    {
+        audio_frame_release();
+        tx_state = PCM_TX_IDLE;
+    }
+
+    if (tx_state != PCM_TX_IDLE)
+    {
+        return;
+    }
+
+    src = audio_frame_acquire(&seq);
+    if (src == NULL)
+    {
+        return;
+    }
+
+    frame_n = audio_frame_length();
+    tx_header.magic = PCM_CAPTURE_MAGIC;
+    tx_header.version = PCM_CAPTURE_VERSION;
+    tx_header.channels = 2U;
+    tx_header.frame_n = (uint16_t)frame_n;
+    tx_header.seq = seq;
+    tx_header.tick_ms = audio_frame_tick(); /* 采集时刻，而非串口积压后的发送时刻 */
+    tx_header.fs_hz = FS_HZ;
+
+    tx_payload = src;
+    tx_payload_len = (uint16_t)(frame_n * 2U * sizeof(uint16_t));
+    tx_state = PCM_TX_HEADER;
+
+    if (HAL_UART_Transmit_DMA(&huart1, (const uint8_t *)&tx_header, sizeof(tx_header)) != HAL_OK)
+    {
+        /* 串口被占用，本帧放弃 */
+        tx_state = PCM_TX_IDLE;
+        audio_frame_release();
+    }
+}
+
+/**
+ * @brief 串口 DMA 发送完成回调
+ */
+void pcm_capture_tx_cplt_callback(void)
+{
+    if (tx_state == PCM_TX_HEADER)
+    {
+        tx_state = PCM_TX_PAYLOAD;
+        if (HAL_UART_Transmit_DMA(&huart1, (const uint8_t *)tx_payload, tx_payload_len) != HAL_OK)
+        {
+            tx_state = PCM_TX_DONE;
+        }
+    }
+    else if (tx_state == PCM_TX_PAYLOAD)
+    {
+        tx_state = PCM_TX_DONE;
+    }
+}
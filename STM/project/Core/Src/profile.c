@@ -0,0 +1,214 @@
+/**
+ * @file profile.c
+ * @brief 基于 DWT 周期计数器的分段耗时统计实现
+ *
+ * 直方图按 1/4 倍频程分桶：c < 4 时桶号为 c，否则设最高位为 e，
+ * 桶号 4*(e-1) + 次高两位，相对分辨率约 19%，32 位计数共 124 个桶。
+ * p99 取累计计数达到 99% 的桶的上界。
+ */
+#include "profile.h"
+#include "USART.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PROF_HIST_BINS 124U
+
+/**
+ * @brief 单个分段的统计
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROF_HIST_BINS];
+} profile_stat_t;
+
+/* 统计只在记录时顺序更新，放在 AXI SRAM 不占用 DTCM（NOLOAD，由 profile_reset 清零） */
+__attribute__((section(".axi_ram"), aligned(32))) static profile_stat_t prof_stats[PROF_SCOPE_COUNT];
+
+static const char *const prof_names[PROF_SCOPE_COUNT] = {
+    "frame_get", "preprocess", "fft", "cross_phat", "lag_eval",
+    "peak", "interp", "gcc_total", "output", "frame_total",
+};
+
+/* 每次估计的周期预算 */
+static uint32_t prof_budget = 0;
+
+/**
+ * @brief 周期数对应的直方图桶号
+ */
+static uint32_t hist_bin(uint32_t cycles)
+{
+    if (cycles < 4U)
+    {
+        return cycles;
+    }
+
+    uint32_t e = 31U - __CLZ(cycles);
+    return 4U * (e - 1U) + ((cycles >> (e - 2U)) & 3U);
+}
+
+/**
+ * @brief 直方图桶的上界（含）
+ */
+static uint32_t hist_upper(uint32_t bin)
+{
+    if (bin < 4U)
+    {
+        return bin;
+    }
+
+    uint32_t e = bin / 4U + 1U;
+    uint32_t lower = (4U + (bin & 3U)) << (e - 2U);
+    return lower + ((1UL << (e - 2U)) - 1U);
+}
+
+/**
+ * @brief 使能 DWT 周期计数器并清空统计
+ */
+void profile_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    profile_reset();
+}
+
+/**
+ * @brief 清空统计
+ */
+void profile_reset(void)
+{
+    memset(prof_stats, 0, sizeof(prof_stats));
+    for (uint32_t i = 0; i < PROF_SCOPE_COUNT; i++)
+    {
+        prof_stats[i].min = UINT32_MAX;
+    }
+}
+
+/**
+ * @brief 设置每次估计的周期预算
+ */
+void profile_set_budget(uint32_t fs_hz, uint32_t hop)
+{
+    prof_budget = (uint32_t)(((uint64_t)SystemCoreClock * hop) / fs_hz);
+}
+
+/**
+ * @brief 记录一次分段耗时
+ */
+void profile_record(profile_scope_t id, uint32_t cycles)
+{
+    profile_stat_t *st = &prof_stats[id];
+
+    st->count++;
+    st->sum += cycles;
+    if (cycles < st->min)
+    {
+        st->min = cycles;
+    }
+    if (cycles > st->max)
+    {
+        st->max = cycles;
+    }
+    st->hist[hist_bin(cycles)]++;
+}
+
+/**
+ * @brief 由直方图估计 p99
+ */
+static uint32_t stat_p99(const profile_stat_t *st)
+{
+    uint32_t target = st->count - st->count / 100U; /* 至少覆盖 99% 的样本 */
+    uint32_t acc = 0;
+
+    for (uint32_t b = 0; b < PROF_HIST_BINS; b++)
+    {
+        acc += st->hist[b];
+        if (acc >= target)
+        {
+            /* 桶上界不超过实测最大值 */
+            uint32_t up = hist_upper(b);
+            return (up < st->max) ? up : st->max;
+        }
+    }
+    return st->max;
+}
+
+/**
+ * @brief 输出所有分段统计
+ */
+void profile_dump(void)
+{
+    uint32_t mhz = SystemCoreClock / 1000000U;
+
+    printf("[prof] budget:%lu cyc (%lu us @ %lu MHz)\r\n",
+           (unsigned long)prof_budget,
+           (unsigned long)(mhz ? prof_budget / mhz : 0U),
+           (unsigned long)mhz);
+    printf("[prof] %-11s %8s %8s %8s %8s %8s %6s\r\n",
+           "scope", "n", "min", "mean", "p99", "max", "p99%");
+    USART1_TxFlush();
+
+    for (uint32_t i = 0; i < PROF_SCOPE_COUNT; i++)
+    {
+        const profile_stat_t *st = &prof_stats[i];
+
+        if (st->count == 0U)
+        {
+            continue;
+        }
+
+        uint32_t p99 = stat_p99(st);
+        printf("[prof] %-11s %8lu %8lu %8lu %8lu %8lu %5.1f%%\r\n",
+               prof_names[i],
+               (unsigned long)st->count,
+               (unsigned long)st->min,
+               (unsigned long)(st->sum / st->count),
+               (unsigned long)p99,
+               (unsigned long)st->max,
+               prof_budget ? (double)p99 * 100.0 / (double)prof_budget : 0.0);
+
+        /* 发送环只有 USART_TX_RING_SIZE 字节，逐行等待发完 */
+        USART1_TxFlush();
+    }
+
+    if (prof_stats[PROF_FRAME_TOTAL].count != 0U)
+    {
+        uint32_t worst = prof_stats[PROF_FRAME_TOTAL].max;
+        printf("[prof] headroom (worst frame): %ld cyc\r\n",
+               (long)prof_budget - (long)worst);
+    }
+
+#if TELEMETRY_ENABLE
+    {
+        /* 遥测帧分隔符，使上面的文本在解码端自成一帧 */
+        static const uint8_t delim = 0x00U;
+        (void)USART1_Write(&delim, 1U);
+    }
+#endif
+    USART1_TxFlush();
+}
+
+/**
+ * @brief 轮询串口命令
+ */
+void profile_poll(void)
+{
+    uint8_t ch;
+
+    if (!USART1_ReadByte(&ch))
+    {
+        return;
+    }
+
+    if (ch == 'p')
+    {
+        profile_dump();
+    }
+    else if (ch == 'r')
+    {
+        profile_reset();
+    }
+}
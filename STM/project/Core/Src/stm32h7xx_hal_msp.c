@@ -3,5 +3,8 @@
 void HAL_MspInit(void)
 {
   __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+  /* D2 SRAM1 存放 DMA 缓冲区 (.dma_d2) */
+  __HAL_RCC_D2SRAM1_CLK_ENABLE();
 }
 
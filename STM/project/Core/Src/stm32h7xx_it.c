@@ -1,6 +1,7 @@
 #include "main.h"
 #include "stm32h7xx_it.h"
 #include "adc_dma.h"
+#include "USART.h"
 
 void NMI_Handler(void)
 {
@@ -58,3 +59,13 @@ void DMA1_Stream0_IRQHandler(void)
 {
   HAL_DMA_IRQHandler(&hdma_adc1);
 }
+
+void DMA1_Stream1_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
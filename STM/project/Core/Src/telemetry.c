@@ -0,0 +1,101 @@
+/**
+ * @file telemetry.c
+ * @brief DOA 二进制遥测模块实现
+ */
+#include "telemetry.h"
+#include "USART.h"
+#include <string.h>
+
+/* 记录 + CRC 的原始长度 */
+#define TELEMETRY_RAW_LEN (sizeof(telemetry_record_t) + 2U)
+
+/* COBS 编码后最长长度（每 254 字节增加 1 字节开销）+ 分隔符 */
+#define TELEMETRY_FRAME_LEN (TELEMETRY_RAW_LEN + TELEMETRY_RAW_LEN / 254U + 2U)
+
+/**
+ * @brief 初始化遥测输出
+ */
+HAL_StatusTypeDef telemetry_init(void)
+{
+    /* 等启动信息发完后再切换波特率 */
+    USART1_TxFlush();
+    return USART1_SetBaudRate(TELEMETRY_BAUD);
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE，逐字节移位实现，无需查表
+ */
+uint16_t telemetry_crc16(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFFU;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc = (uint16_t)((crc >> 8) | (crc << 8));
+        crc ^= data[i];
+        crc ^= (uint16_t)((crc & 0xFFU) >> 4);
+        crc ^= (uint16_t)(crc << 12);
+        crc ^= (uint16_t)((crc & 0xFFU) << 5);
+    }
+    return crc;
+}
+
+/**
+ * @brief COBS 编码
+ * @param src 原始数据
+ * @param len 原始长度
+ * @param dst 输出缓冲区（不含分隔符）
+ * @retval 编码后长度
+ */
+static uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t code_pos = 0;
+    uint32_t out = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (src[i] == 0U)
+        {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+        else
+        {
+            dst[out++] = src[i];
+            code++;
+            if (code == 0xFFU)
+            {
+                dst[code_pos] = code;
+                code_pos = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_pos] = code;
+
+    return out;
+}
+
+/**
+ * @brief 编码并发送一条记录
+ */
+void telemetry_send(telemetry_record_t *rec)
+{
+    uint8_t raw[TELEMETRY_RAW_LEN];
+    uint8_t frame[TELEMETRY_FRAME_LEN];
+    uint16_t crc;
+    uint32_t n;
+
+    rec->version = TELEMETRY_VERSION;
+    memcpy(raw, rec, sizeof(*rec));
+    crc = telemetry_crc16(raw, sizeof(*rec));
+    raw[sizeof(*rec)] = (uint8_t)(crc & 0xFFU);
+    raw[sizeof(*rec) + 1U] = (uint8_t)(crc >> 8);
+
+    n = cobs_encode(raw, sizeof(raw), frame);
+    frame[n++] = 0x00U;
+
+    (void)USART1_Write(frame, n);
+}
@@ -0,0 +1,26 @@
+/**
+ * @file Servo.h
+ * @brief 主机构建用的舵机驱动替身（取代 Core/Inc/servo.h）
+ *
+ * 不输出 PWM，舵机目标角度可经 servo_ctrl_get_angle() 读取。
+ */
+#ifndef __SERVO_H__
+#define __SERVO_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+
+    /**
+     * @brief 设定舵机角度 (0-180 度)
+     */
+    HAL_StatusTypeDef Servo_SetAngle(uint8_t angle_deg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file host_stub.h
+ * @brief 主机构建的外设模拟接口
+ *
+ * 供主机程序驱动流水线：向模拟的 ADC DMA 灌入 PCM 采样，
+ * 指定 USART1 二进制输出（遥测帧）的去向，以及公用的启动流程。
+ */
+#ifndef __HOST_STUB_H__
+#define __HOST_STUB_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include <stdio.h>
+
+    /**
+     * @brief 向模拟 ADC DMA 写入采样对
+     * @param pcm 交错的有符号 16 位采样 [CH0, CH1, ...]
+     * @param pairs 采样对数
+     * @retval 期间写满并交付的 DMA 帧数（每帧触发一次 HAL_ADC_ConvCpltCallback()）
+     * @note 采样按 ADC 偏移码写入 DMA 缓冲区，与硬件数据格式一致；
+     *       DMA 未启动时丢弃
+     */
+    uint32_t host_adc_feed(const int16_t *pcm, uint32_t pairs);
+
+    /**
+     * @brief 向模拟 ADC DMA 原样写入 ADC 偏移码
+     * @param codes 交错的 ADC 偏移码 [CH0, CH1, ...]，即 DMA 缓冲区格式
+     * @param pairs 采样对数
+     * @retval 期间写满并交付的 DMA 帧数
+     */
+    uint32_t host_adc_feed_codes(const uint16_t *codes, uint32_t pairs);
+
+    /**
+     * @brief 初始化 DOA 系统并切换到与采样率匹配的档位
+     * @param fs_hz 输入采样率
+     * @param requested 指定档位编号，负数时选第一个采样率匹配的档位
+     * @retval 档位编号，失败时返回 -1（已打印原因）
+     */
+    int host_app_start(uint32_t fs_hz, int requested);
+
+    /**
+     * @brief 模拟 ADC 当前采样率
+     */
+    uint32_t host_adc_rate(void);
+
+    /**
+     * @brief 设置 USART1_Write() 的输出文件
+     * @param sink 输出文件，NULL 时丢弃
+     * @note printf 直接输出到 stdout，不经过此处
+     */
+    void host_uart_set_sink(FILE *sink);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_STUB_H__ */
@@ -0,0 +1,79 @@
+/**
+ * @file scene.h
+ * @brief 双麦克风声学场景合成（主机端）
+ *
+ * 在矩形房间中放置若干白噪声声源，按镜像源法生成到两个麦克风的多径，
+ * 每条路径用加窗 sinc 实现分数延迟，可选声源匀速扫过一段角度，
+ * 最后按给定信噪比叠加各通道独立的白噪声，输出 ADC 偏移码交错采样。
+ *
+ * 坐标系：麦克风 1、2 位于阵列中心两侧的 x 轴上（麦克风 2 在 +x 方向），
+ * 阵列法线为 +y。角度相对法线、朝麦克风 2 为正，与 gcc_phat 的 theta_deg 同号。
+ */
+#ifndef __SCENE_H__
+#define __SCENE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+#include "config.h"
+
+/* 最多声源数 */
+#define SCENE_SOURCES_MAX 4U
+
+    /**
+     * @brief 声源参数
+     */
+    typedef struct
+    {
+        float theta0_deg; /* 起始角度 */
+        float theta1_deg; /* 结束角度，与起始角度相同即为静止声源 */
+        float level_db;   /* 相对电平 (dB) */
+    } scene_source_t;
+
+    /**
+     * @brief 场景参数
+     */
+    typedef struct
+    {
+        uint32_t fs_hz;
+        float duration_s;
+        float snr_db;       /* 各通道噪声相对干净信号功率 */
+        float mic_dist_m;   /* 麦克风间距 */
+        float src_dist_m;   /* 声源到阵列中心距离 */
+        float room_m[3];    /* 房间尺寸 */
+        float array_m[3];   /* 阵列中心位置 */
+        float beta;         /* 墙面反射系数，0 为消声环境 */
+        uint32_t order;     /* 镜像源最高反射次数 */
+        uint32_t seed;      /* 随机数种子 */
+        uint32_t n_sources;
+        scene_source_t src[SCENE_SOURCES_MAX];
+    } scene_t;
+
+    /**
+     * @brief 填入默认场景：FS_HZ、3 s、消声、SNR 20 dB、6x5x3 m 房间、无声源
+     */
+    void scene_defaults(scene_t *sc);
+
+    /**
+     * @brief 声源 k 在 t 时刻的角度
+     */
+    float scene_source_theta(const scene_t *sc, uint32_t k, float t_s);
+
+    /**
+     * @brief 合成整段录音
+     * @param sc 场景参数
+     * @param pairs 输出采样对数
+     * @retval 交错格式的 ADC 偏移码 [CH0, CH1, ...]（malloc 分配，由调用方释放），
+     *         参数非法或声源位于房间外时返回 NULL
+     * @note 峰值归一化到满量程的一半
+     */
+    uint16_t *scene_render(const scene_t *sc, uint32_t *pairs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCENE_H__ */
@@ -0,0 +1,84 @@
+/**
+ * @file stm32h7xx_hal.h
+ * @brief 主机构建用的 HAL 替身
+ *
+ * Core/Inc/main.h 只包含本文件，主机构建的头文件搜索路径中没有 HAL 驱动目录，
+ * 因此各模块经 main.h 得到的是这里的定义。
+ * 只提供 DSP 流水线用到的 HAL/CMSIS 符号：HAL_StatusTypeDef、SystemCoreClock、HAL_GetTick、
+ * DWT 周期计数器与少量内核内建函数。DWT->CYCCNT 每次读取时由 host_dwt() 刷新：
+ * Linux 主机按单调时钟换算为 SystemCoreClock 周期（host_clock.c），
+ * QEMU mps2-an500 构建为 -icount 下的指令数（Qemu/Src/qemu_clock.c）。
+ */
+#ifndef __STM32H7xx_HAL_H
+#define __STM32H7xx_HAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cmsis_compiler.h"
+
+    typedef enum
+    {
+        HAL_OK = 0x00U,
+        HAL_ERROR = 0x01U,
+        HAL_BUSY = 0x02U,
+        HAL_TIMEOUT = 0x03U
+    } HAL_StatusTypeDef;
+
+    extern uint32_t SystemCoreClock;
+
+    /**
+     * @brief 毫秒节拍，按模拟 ADC 已写入的采样数推进（与输入录音的时间轴一致）
+     */
+    uint32_t HAL_GetTick(void);
+
+    /**
+     * @brief DWT 寄存器替身，只保留用到的字段
+     */
+    typedef struct
+    {
+        volatile uint32_t CTRL;
+        volatile uint32_t CYCCNT;
+        volatile uint32_t LAR;
+    } DWT_Type;
+
+    typedef struct
+    {
+        volatile uint32_t DEMCR;
+    } CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+    /**
+     * @brief 刷新 CYCCNT 后返回 DWT 替身
+     */
+    DWT_Type *host_dwt(void);
+
+    extern CoreDebug_Type host_core_debug;
+
+#define DWT (host_dwt())
+#define CoreDebug (&host_core_debug)
+
+/* cmsis_gcc.h 中的屏障是 ARM 汇编，主机上换成编译器全屏障 */
+#if !defined(__arm__)
+#undef __DMB
+#define __DMB() __sync_synchronize()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/* 与真实 HAL 一样一次引入全部外设头文件 */
+#include "stm32h7xx_hal_adc.h"
+#include "stm32h7xx_hal_dma.h"
+#include "stm32h7xx_hal_tim.h"
+#include "stm32h7xx_hal_uart.h"
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file stm32h7xx_hal_adc.h
+ * @brief 主机构建用的 ADC 句柄替身
+ *
+ * ADC 与 DMA 由 hal_stub.c 模拟：host_adc_feed() 把采样写入当前 DMA 目标缓冲区，
+ * 写满一帧即调用 HAL_ADC_ConvCpltCallback()，与双缓冲 DMA 的中断时序一致。
+ */
+#ifndef __STM32H7xx_HAL_ADC_H
+#define __STM32H7xx_HAL_ADC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32h7xx_hal.h"
+
+    typedef struct
+    {
+        uint32_t fs_hz; /* 模拟的采样率（由 ADC_DMA_SetSampleRate() 设定） */
+    } ADC_TypeDef;
+
+    typedef struct
+    {
+        ADC_TypeDef *Instance;
+    } ADC_HandleTypeDef;
+
+    extern ADC_TypeDef host_adc1;
+#define ADC1 (&host_adc1)
+
+    void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
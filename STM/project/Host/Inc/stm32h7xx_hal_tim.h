@@ -0,0 +1,24 @@
+/**
+ * @file stm32h7xx_hal_tim.h
+ * @brief 主机构建用的 TIM 句柄替身，只为满足头文件中的 extern 声明
+ */
+#ifndef __STM32H7xx_HAL_TIM_H
+#define __STM32H7xx_HAL_TIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32h7xx_hal.h"
+
+    typedef struct
+    {
+        void *Instance;
+    } TIM_HandleTypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file wav_in.h
+ * @brief 双声道 16 位 PCM WAV 读取（主机端与 QEMU 构建共用）
+ */
+#ifndef __WAV_IN_H__
+#define __WAV_IN_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+    /**
+     * @brief WAV 输入
+     */
+    typedef struct
+    {
+        FILE *f;
+        uint32_t fs_hz;
+        uint32_t pairs; /* data 块中的采样对数 */
+    } wav_in_t;
+
+    /**
+     * @brief 打开 WAV 并定位到 data 块
+     * @param w 输出，成功后 w->f 指向第一个采样对，由调用方关闭
+     * @param path 文件路径
+     * @retval 0: 成功; -1: 失败（已打印原因）
+     * @note 只接受双声道 16 位 PCM（含 WAVE_FORMAT_EXTENSIBLE）
+     */
+    int wav_open(wav_in_t *w, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WAV_IN_H__ */
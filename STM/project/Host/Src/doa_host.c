@@ -0,0 +1,225 @@
+/**
+ * @file doa_host.c
+ * @brief 主机端 DOA 流水线驱动程序
+ *
+ * 读取双声道 16 位 PCM WAV，按 hop 灌入模拟 ADC DMA，经与固件相同的
+ * audio_frame -> frame_window -> gcc_phat -> app_doa 路径逐帧估计，
+ * 输出每次估计的 CSV 与汇总统计，便于用 perf / valgrind 分析。
+ *
+ * 用法:
+ *     doa_host [-p 档位] [-c out.csv] [-t telemetry.bin] input.wav
+ *     doa_host -b                 运行 dsp_bench 基准测试
+ */
+#include "host_stub.h"
+#include "wav_in.h"
+#include "app_doa.h"
+#include "frame_window.h"
+#include "deadline.h"
+#include "dsp_bench.h"
+#include "profile.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 每次读取的采样对数 */
+#define HOST_BLOCK_PAIRS 256U
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-p profile] [-c out.csv] [-t telemetry.bin] input.wav\n"
+            "       %s -b    run the dsp_bench kernels\n",
+            prog, prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *csv_path = NULL;
+    const char *tel_path = NULL;
+    int requested = -1;
+    bool bench = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:c:t:bh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            requested = atoi(optarg);
+            break;
+        case 'c':
+            csv_path = optarg;
+            break;
+        case 't':
+            tel_path = optarg;
+            break;
+        case 'b':
+            bench = true;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (bench)
+    {
+        return (dsp_bench_run() == HAL_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (optind != argc - 1)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    wav_in_t wav = {0};
+    if (wav_open(&wav, argv[optind]) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = NULL;
+    FILE *tel = NULL;
+    if (csv_path != NULL && (csv = fopen(csv_path, "w")) == NULL)
+    {
+        perror(csv_path);
+        return EXIT_FAILURE;
+    }
+    if (tel_path != NULL && (tel = fopen(tel_path, "wb")) == NULL)
+    {
+        perror(tel_path);
+        return EXIT_FAILURE;
+    }
+    host_uart_set_sink(tel);
+
+    int idx = host_app_start(wav.fs_hz, requested);
+    if (idx < 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    const app_doa_profile_t *prof = app_doa_get_profile((uint32_t)idx);
+    uint32_t hop = prof->frame_n / FRAME_HOP_DIV;
+
+    printf("input: %s fs=%lu Hz, %.2f s\n", argv[optind], (unsigned long)wav.fs_hz,
+           (double)wav.pairs / (double)wav.fs_hz);
+    printf("profile %d: frame=%lu hop=%lu fft=%lu\n", idx, (unsigned long)prof->frame_n,
+           (unsigned long)hop, (unsigned long)prof->fft_l);
+
+    if (csv != NULL)
+    {
+        fprintf(csv, "seq,time_s,valid,lag_sub,dt,theta_deg,peak,ratio,theta_smooth\n");
+    }
+
+    static int16_t block[2U * HOST_BLOCK_PAIRS];
+    uint32_t left = wav.pairs;
+    uint32_t n_hops = 0;
+    uint32_t n_est = 0;
+    uint32_t n_valid = 0;
+    double theta_sum = 0.0;
+    double theta_sq = 0.0;
+    double busy = 0.0;
+    double busy_max = 0.0;
+    double t_start = now_s();
+
+    while (left > 0U)
+    {
+        uint32_t n = (left < HOST_BLOCK_PAIRS) ? left : HOST_BLOCK_PAIRS;
+
+        n = (uint32_t)fread(block, 4U, n, wav.f);
+        if (n == 0U)
+        {
+            break; /* data 块长度超出文件实际长度 */
+        }
+        left -= n;
+        (void)host_adc_feed(block, n);
+
+        /* 与主循环相同：每交付一个 hop 处理一次 */
+        while (app_doa_frame_ready())
+        {
+            gcc_phat_result_t r;
+            float smooth;
+            double t0 = now_s();
+
+            app_doa_process_frame();
+            app_doa_servo_update();
+
+            double dt = now_s() - t0;
+            busy += dt;
+            if (dt > busy_max)
+            {
+                busy_max = dt;
+            }
+            n_hops++;
+
+            if (!app_doa_get_result(&r, &smooth))
+            {
+                continue; /* 分析窗尚未填满 */
+            }
+
+            uint32_t seq = frame_window_seq();
+            n_est++;
+            if (r.valid)
+            {
+                n_valid++;
+                theta_sum += r.theta_deg;
+                theta_sq += (double)r.theta_deg * r.theta_deg;
+            }
+            if (csv != NULL)
+            {
+                /* 时刻取分析窗末尾 */
+                fprintf(csv, "%lu,%.6f,%d,%.4f,%.9f,%.3f,%.4f,%.3f,%.3f\n",
+                        (unsigned long)seq, (double)(seq + 1U) * hop / (double)wav.fs_hz,
+                        r.valid ? 1 : 0, r.lag_sub, r.dt, r.theta_deg, r.peak, r.ratio, smooth);
+            }
+        }
+    }
+
+    double wall = now_s() - t_start;
+    double audio_s = (double)(wav.pairs - left) / (double)wav.fs_hz;
+    deadline_stats_t dl;
+    deadline_get_stats(&dl);
+
+    printf("estimates: %lu valid: %lu (%.1f%%)\n", (unsigned long)n_est, (unsigned long)n_valid,
+           n_est ? 100.0 * n_valid / n_est : 0.0);
+    if (n_valid != 0U)
+    {
+        double mean = theta_sum / n_valid;
+        double var = theta_sq / n_valid - mean * mean;
+        printf("theta valid mean: %.2f deg, std: %.2f deg\n", mean, sqrt(var > 0.0 ? var : 0.0));
+    }
+    printf("per hop: mean %.1f us, max %.1f us (hop period %.1f us, load %lu%%)\n",
+           n_hops ? busy * 1e6 / n_hops : 0.0, busy_max * 1e6,
+           1e6 * hop / (double)wav.fs_hz, (unsigned long)dl.load_pct);
+    printf("wall: %.3f s for %.2f s audio (%.0fx realtime)\n", wall, audio_s,
+           wall > 0.0 ? audio_s / wall : 0.0);
+
+#if PROFILE_ENABLE
+    profile_dump();
+#endif
+
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+    if (tel != NULL)
+    {
+        fclose(tel);
+    }
+    fclose(wav.f);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,443 @@
+/**
+ * @file doa_scene.c
+ * @brief 合成场景端到端 DOA 回归基准
+ *
+ * 按场景参数合成双麦克风录音（ADC 偏移码，即 DMA 缓冲区格式），按 hop 灌入
+ * 模拟 ADC DMA，经 audio_frame -> frame_window -> gcc_phat -> app_doa 逐帧估计，
+ * 与真实角度比较，输出角度 RMSE、有效帧率、离群率与每帧耗时。
+ * 不给出声源时运行内置场景集，每个场景一行，用于算法或性能改动前后对比；
+ * 任一场景的精度超出其阈值时以非零状态退出（ctest 的 doa_scene 测试）。
+ * 每帧耗时随主机负载波动，只输出不判决。
+ *
+ * 用法:
+ *     doa_scene                               运行内置场景集
+ *     doa_scene -s 30 -s -45,-6 -n 10 -b 0.6  自定义场景
+ *
+ * 声源格式 "起始角[:结束角][,电平dB]"，如 "-60:60" 为 -60 度匀速扫到 60 度。
+ */
+#include "host_stub.h"
+#include "scene.h"
+#include "app_doa.h"
+#include "frame_window.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 误差超过此值计为离群 (度) */
+#define SCENE_OUTLIER_DEG 5.0f
+
+/**
+ * @brief 一个场景的精度统计
+ */
+typedef struct
+{
+    float rmse_deg;    /* 有效估计的角度 RMSE */
+    float valid_pct;   /* 有效估计占比 */
+    float outlier_pct; /* 离群占有效估计的比例 */
+} scene_stats_t;
+
+/**
+ * @brief 内置场景，阈值比当前实测结果留一定余量，用于发现精度退化
+ */
+typedef struct
+{
+    const char *name;
+    float snr_db;
+    float beta;
+    uint32_t order;
+    uint32_t n_sources;
+    scene_source_t src[2];
+    scene_stats_t limit; /* rmse / 离群率上限，有效率下限 */
+} scene_case_t;
+
+static const scene_case_t scene_suite[] = {
+    {"anechoic_0", 30.0f, 0.0f, 0U, 1U, {{0.0f, 0.0f, 0.0f}}, {0.2f, 99.0f, 0.0f}},
+    {"anechoic_+30", 30.0f, 0.0f, 0U, 1U, {{30.0f, 30.0f, 0.0f}}, {0.2f, 99.0f, 0.0f}},
+    {"anechoic_-60", 30.0f, 0.0f, 0U, 1U, {{-60.0f, -60.0f, 0.0f}}, {0.2f, 99.0f, 0.0f}},
+    {"snr0_+20", 0.0f, 0.0f, 0U, 1U, {{20.0f, 20.0f, 0.0f}}, {0.8f, 98.0f, 1.0f}},
+    {"snr-5_+20", -5.0f, 0.0f, 0U, 1U, {{20.0f, 20.0f, 0.0f}}, {1.5f, 85.0f, 2.0f}},
+    {"reverb0.7_-40", 20.0f, 0.7f, 3U, 1U, {{-40.0f, -40.0f, 0.0f}}, {0.6f, 98.0f, 1.0f}},
+    {"reverb0.9_-40", 20.0f, 0.9f, 6U, 1U, {{-40.0f, -40.0f, 0.0f}}, {1.6f, 35.0f, 2.0f}},
+    {"moving_-60:+60", 20.0f, 0.0f, 0U, 1U, {{-60.0f, 60.0f, 0.0f}}, {0.8f, 98.0f, 1.0f}},
+    {"two_src_+30/-45", 20.0f, 0.0f, 0U, 2U, {{30.0f, 30.0f, 0.0f}, {-45.0f, -45.0f, -6.0f}},
+     {0.5f, 98.0f, 1.0f}},
+};
+
+#define SCENE_SUITE_COUNT (sizeof(scene_suite) / sizeof(scene_suite[0]))
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 把偏移码录音写成双声道 16 位 WAV
+ */
+static int write_wav(const char *path, const uint16_t *codes, uint32_t pairs, uint32_t fs_hz)
+{
+    FILE *f = fopen(path, "wb");
+    uint32_t data = pairs * 4U;
+    uint8_t hdr[44];
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    memcpy(&hdr[0], "RIFF", 4);
+    memcpy(&hdr[8], "WAVEfmt ", 8);
+    memcpy(&hdr[36], "data", 4);
+    const uint32_t w32[][2] = {{4, 36U + data}, {16, 16U}, {24, fs_hz}, {28, fs_hz * 4U}, {40, data}};
+    for (uint32_t i = 0; i < sizeof(w32) / sizeof(w32[0]); i++)
+    {
+        uint32_t v = w32[i][1];
+        for (uint32_t b = 0; b < 4U; b++)
+        {
+            hdr[w32[i][0] + b] = (uint8_t)(v >> (8U * b));
+        }
+    }
+    hdr[20] = 1U; /* PCM */
+    hdr[21] = 0U;
+    hdr[22] = 2U; /* 双声道 */
+    hdr[23] = 0U;
+    hdr[32] = 4U; /* 块对齐 */
+    hdr[33] = 0U;
+    hdr[34] = 16U;
+    hdr[35] = 0U;
+    fwrite(hdr, 1, sizeof(hdr), f);
+
+    for (uint32_t i = 0; i < 2U * pairs; i++)
+    {
+        uint16_t s = codes[i] ^ 0x8000U; /* 偏移码转补码 */
+        uint8_t le[2] = {(uint8_t)s, (uint8_t)(s >> 8)};
+        fwrite(le, 1, 2, f);
+    }
+
+    fclose(f);
+    return 0;
+}
+
+/**
+ * @brief 估计值与最近声源的角度误差
+ */
+static float truth_error(const scene_t *sc, float theta_est, float t_s, float *truth)
+{
+    float best = 1e9f;
+
+    for (uint32_t k = 0; k < sc->n_sources; k++)
+    {
+        float th = scene_source_theta(sc, k, t_s);
+        if (fabsf(theta_est - th) < fabsf(best))
+        {
+            best = theta_est - th;
+            *truth = th;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 合成并评估一个场景
+ * @param stats 输出精度统计
+ * @retval 0: 成功; -1: 失败
+ */
+static int run_scene(const char *name, const scene_t *sc, int requested, FILE *csv, const char *wav_path,
+                     scene_stats_t *stats)
+{
+    uint32_t pairs;
+    uint16_t *codes = scene_render(sc, &pairs);
+
+    if (codes == NULL)
+    {
+        fprintf(stderr, "%s: scene synthesis failed\n", name);
+        return -1;
+    }
+    if (wav_path != NULL && write_wav(wav_path, codes, pairs, sc->fs_hz) != 0)
+    {
+        free(codes);
+        return -1;
+    }
+
+    int idx = host_app_start(sc->fs_hz, requested);
+    if (idx < 0)
+    {
+        free(codes);
+        return -1;
+    }
+
+    const app_doa_profile_t *prof = app_doa_get_profile((uint32_t)idx);
+    uint32_t hop = prof->frame_n / FRAME_HOP_DIV;
+    uint32_t n_est = 0;
+    uint32_t n_valid = 0;
+    uint32_t n_outlier = 0;
+    double err_sq = 0.0;
+    double ns_sum = 0.0;
+    double ns_max = 0.0;
+
+    for (uint32_t off = 0; off < pairs; off += hop)
+    {
+        uint32_t n = (pairs - off < hop) ? pairs - off : hop;
+
+        (void)host_adc_feed_codes(&codes[2U * off], n);
+
+        while (app_doa_frame_ready())
+        {
+            gcc_phat_result_t r;
+            double t0 = now_s();
+
+            app_doa_process_frame();
+
+            double ns = (now_s() - t0) * 1e9;
+            if (!app_doa_get_result(&r, NULL))
+            {
+                continue; /* 分析窗尚未填满 */
+            }
+            ns_sum += ns;
+            if (ns > ns_max)
+            {
+                ns_max = ns;
+            }
+            n_est++;
+
+            /* 真实角度取分析窗中心时刻 */
+            uint32_t seq = frame_window_seq();
+            float t_s = ((float)((seq + 1U) * hop) - 0.5f * (float)prof->frame_n) / (float)sc->fs_hz;
+            float truth = 0.0f;
+            float err = 0.0f;
+
+            if (r.valid)
+            {
+                err = truth_error(sc, r.theta_deg, t_s, &truth);
+                n_valid++;
+                err_sq += (double)err * err;
+                if (fabsf(err) > SCENE_OUTLIER_DEG)
+                {
+                    n_outlier++;
+                }
+            }
+            if (csv != NULL)
+            {
+                fprintf(csv, "%s,%lu,%.6f,%d,%.3f,%.3f,%.3f,%.4f,%.3f\n", name, (unsigned long)seq,
+                        t_s, r.valid ? 1 : 0, truth, r.theta_deg, err, r.peak, r.ratio);
+            }
+        }
+    }
+
+    stats->valid_pct = n_est ? 100.0f * (float)n_valid / (float)n_est : 0.0f;
+    stats->rmse_deg = n_valid ? (float)sqrt(err_sq / n_valid) : 0.0f;
+    stats->outlier_pct = n_valid ? 100.0f * (float)n_outlier / (float)n_valid : 0.0f;
+
+    printf("[scene] %-16s est:%4lu valid:%5.1f%% rmse:%6.2f deg outlier:%5.1f%% ns/frame:%8.0f max:%8.0f\n",
+           name, (unsigned long)n_est, (double)stats->valid_pct, (double)stats->rmse_deg,
+           (double)stats->outlier_pct, n_est ? ns_sum / n_est : 0.0, ns_max);
+
+    free(codes);
+    return 0;
+}
+
+/**
+ * @brief 按场景阈值判决，逐项输出超限原因
+ * @retval true: 全部在阈值内
+ */
+static bool check_scene(const scene_case_t *c, const scene_stats_t *st)
+{
+    bool pass = true;
+
+    if (st->rmse_deg > c->limit.rmse_deg)
+    {
+        printf("[scene] %-16s FAIL rmse %.2f > %.2f deg\n", c->name, (double)st->rmse_deg,
+               (double)c->limit.rmse_deg);
+        pass = false;
+    }
+    if (st->valid_pct < c->limit.valid_pct)
+    {
+        printf("[scene] %-16s FAIL valid %.1f%% < %.1f%%\n", c->name, (double)st->valid_pct,
+               (double)c->limit.valid_pct);
+        pass = false;
+    }
+    if (st->outlier_pct > c->limit.outlier_pct)
+    {
+        printf("[scene] %-16s FAIL outlier %.1f%% > %.1f%%\n", c->name, (double)st->outlier_pct,
+               (double)c->limit.outlier_pct);
+        pass = false;
+    }
+    return pass;
+}
+
+/**
+ * @brief 解析声源参数 "起始角[:结束角][,电平dB]"
+ */
+static int parse_source(const char *arg, scene_source_t *s)
+{
+    char *end;
+
+    s->theta0_deg = strtof(arg, &end);
+    if (end == arg)
+    {
+        return -1;
+    }
+    s->theta1_deg = s->theta0_deg;
+    s->level_db = 0.0f;
+    if (*end == ':')
+    {
+        arg = end + 1;
+        s->theta1_deg = strtof(arg, &end);
+        if (end == arg)
+        {
+            return -1;
+        }
+    }
+    if (*end == ',')
+    {
+        arg = end + 1;
+        s->level_db = strtof(arg, &end);
+        if (end == arg)
+        {
+            return -1;
+        }
+    }
+    /* 双麦克风阵列前后对称，法线两侧 ±90 度以外无法区分 */
+    if (fabsf(s->theta0_deg) > 90.0f || fabsf(s->theta1_deg) > 90.0f)
+    {
+        return -1;
+    }
+    return (*end == '\0') ? 0 : -1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]   (no -s: run the built-in scene suite)\n"
+            "  -s deg[:deg_end][,level_db]  add a source (up to %u)\n"
+            "  -n snr_db      noise (default 20)\n"
+            "  -b beta        wall reflection coefficient, 0 = anechoic (default 0)\n"
+            "  -o order       image-source reflection order (default 2)\n"
+            "  -r dist_m      source distance (default 1.5)\n"
+            "  -T seconds     duration (default 3)\n"
+            "  -f fs_hz       sample rate (default %u)\n"
+            "  -S seed        noise seed\n"
+            "  -p profile     app_doa profile index\n"
+            "  -w out.wav     also write the synthesized recording\n"
+            "  -c out.csv     per-estimate truth and error\n",
+            prog, SCENE_SOURCES_MAX, FS_HZ);
+}
+
+int main(int argc, char **argv)
+{
+    scene_t sc;
+    const char *csv_path = NULL;
+    const char *wav_path = NULL;
+    int requested = -1;
+    int opt;
+
+    scene_defaults(&sc);
+
+    while ((opt = getopt(argc, argv, "s:n:b:o:r:T:f:S:p:w:c:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            if (sc.n_sources >= SCENE_SOURCES_MAX || parse_source(optarg, &sc.src[sc.n_sources]) != 0)
+            {
+                fprintf(stderr, "bad or too many sources: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            sc.n_sources++;
+            break;
+        case 'n':
+            sc.snr_db = strtof(optarg, NULL);
+            break;
+        case 'b':
+            sc.beta = strtof(optarg, NULL);
+            break;
+        case 'o':
+            sc.order = (uint32_t)atoi(optarg);
+            break;
+        case 'r':
+            sc.src_dist_m = strtof(optarg, NULL);
+            break;
+        case 'T':
+            sc.duration_s = strtof(optarg, NULL);
+            break;
+        case 'f':
+            sc.fs_hz = (uint32_t)atoi(optarg);
+            break;
+        case 'S':
+            sc.seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            requested = atoi(optarg);
+            break;
+        case 'w':
+            wav_path = optarg;
+            break;
+        case 'c':
+            csv_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL)
+    {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            perror(csv_path);
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "scene,seq,time_s,valid,truth_deg,theta_deg,err_deg,peak,ratio\n");
+    }
+
+    int status = 0;
+    scene_stats_t stats;
+    if (sc.n_sources != 0U)
+    {
+        status = run_scene("custom", &sc, requested, csv, wav_path, &stats);
+    }
+    else
+    {
+        uint32_t failed = 0;
+
+        for (uint32_t i = 0; i < SCENE_SUITE_COUNT && status == 0; i++)
+        {
+            const scene_case_t *c = &scene_suite[i];
+            scene_t s = sc;
+
+            s.snr_db = c->snr_db;
+            s.beta = c->beta;
+            s.order = c->order;
+            s.n_sources = c->n_sources;
+            memcpy(s.src, c->src, sizeof(c->src));
+            status = run_scene(c->name, &s, requested, csv, NULL, &stats);
+            if (status == 0 && !check_scene(c, &stats))
+            {
+                failed++;
+            }
+        }
+
+        /* 超限的场景不中断，跑完整个场景集再判决 */
+        if (status == 0)
+        {
+            printf("[scene] %s (%lu failed)\n", failed ? "FAIL" : "PASS", (unsigned long)failed);
+            status = failed ? -1 : 0;
+        }
+    }
+
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+    return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file hal_stub.c
+ * @brief 主机构建的 HAL 与外设替身实现
+ *
+ * 替换 adc_dma.c、USART.c、Servo.c 与 system_stm32h7xx.c 中被 DSP 流水线
+ * 引用的符号。模拟 DMA 的双缓冲语义：写满当前目标后先切换到预设的下一缓冲区，
+ * 再调用传输完成回调，由回调通过 ADC_DMA_SetNextBuffer() 预设其后一帧的目标。
+ * DWT 周期计数由各平台的 host_dwt() 提供（host_clock.c / Qemu/Src/qemu_clock.c）。
+ */
+#include "host_stub.h"
+#include "adc_dma.h"
+#include "USART.h"
+#include "Servo.h"
+#include <stdlib.h>
+
+/* 主机上按目标板主频换算周期数 */
+uint32_t SystemCoreClock = 240000000U;
+
+CoreDebug_Type host_core_debug;
+ADC_TypeDef host_adc1 = {FS_HZ};
+
+ADC_HandleTypeDef hadc1 = {&host_adc1};
+DMA_HandleTypeDef hdma_adc1;
+TIM_HandleTypeDef htim2;
+UART_HandleTypeDef huart1;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+/* 模拟 DMA 状态 */
+static uint16_t *dma_cur = NULL;  /* 正在写入的缓冲区 */
+static uint16_t *dma_next = NULL; /* 写满后切换到的缓冲区 */
+static uint32_t dma_len = 0;      /* 每帧长度（uint16 个数） */
+static uint32_t dma_pos = 0;
+static bool dma_running = false;
+
+/* 模拟的 HAL 时基：每写入一个采样对累加 1000，满 fs_hz 进 1 ms */
+static uint32_t tick_ms = 0;
+static uint32_t tick_acc = 0;
+
+static FILE *uart_sink = NULL;
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler\n");
+    exit(EXIT_FAILURE);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return tick_ms;
+}
+
+/* ========== ADC + DMA ========== */
+
+void MX_ADC1_Init(void)
+{
+    host_adc1.fs_hz = FS_HZ;
+}
+
+HAL_StatusTypeDef ADC_DMA_Start(uint16_t *buf0, uint16_t *buf1, uint32_t length)
+{
+    if (buf0 == NULL || buf1 == NULL || length == 0U)
+    {
+        return HAL_ERROR;
+    }
+
+    dma_cur = buf0;
+    dma_next = buf1;
+    dma_len = length;
+    dma_pos = 0;
+    dma_running = true;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef ADC_DMA_SetNextBuffer(uint16_t *buffer)
+{
+    dma_next = buffer;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef ADC_DMA_Stop(void)
+{
+    dma_running = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef ADC_DMA_SetSampleRate(uint32_t fs_hz)
+{
+    if (fs_hz == 0U || fs_hz > FS_HZ_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    host_adc1.fs_hz = fs_hz;
+    return HAL_OK;
+}
+
+/**
+ * @brief 写入一个采样对，写满一帧时切换缓冲区并触发传输完成回调
+ * @retval true: 交付了一帧
+ */
+static bool dma_put(uint16_t ch0, uint16_t ch1)
+{
+    dma_cur[dma_pos++] = ch0;
+    dma_cur[dma_pos++] = ch1;
+
+    tick_acc += 1000U;
+    if (tick_acc >= host_adc1.fs_hz)
+    {
+        tick_acc -= host_adc1.fs_hz;
+        tick_ms++;
+    }
+
+    if (dma_pos < dma_len)
+    {
+        return false;
+    }
+
+    dma_pos = 0;
+    dma_cur = dma_next;
+    HAL_ADC_ConvCpltCallback(&hadc1);
+    return true;
+}
+
+/**
+ * @brief 向模拟 ADC DMA 写入采样对
+ */
+uint32_t host_adc_feed(const int16_t *pcm, uint32_t pairs)
+{
+    uint32_t frames = 0;
+
+    for (uint32_t i = 0; i < pairs && dma_running; i++)
+    {
+        /* 有符号采样转 ADC 偏移码 */
+        frames += dma_put((uint16_t)pcm[2U * i] ^ 0x8000U, (uint16_t)pcm[2U * i + 1U] ^ 0x8000U) ? 1U : 0U;
+    }
+
+    return frames;
+}
+
+/**
+ * @brief 向模拟 ADC DMA 写入 ADC 偏移码
+ */
+uint32_t host_adc_feed_codes(const uint16_t *codes, uint32_t pairs)
+{
+    uint32_t frames = 0;
+
+    for (uint32_t i = 0; i < pairs && dma_running; i++)
+    {
+        frames += dma_put(codes[2U * i], codes[2U * i + 1U]) ? 1U : 0U;
+    }
+
+    return frames;
+}
+
+/**
+ * @brief 模拟 ADC 当前采样率
+ */
+uint32_t host_adc_rate(void)
+{
+    return host_adc1.fs_hz;
+}
+
+/* ========== USART1 ========== */
+
+void MX_USART1_UART_Init(void)
+{
+}
+
+HAL_StatusTypeDef USART1_SetBaudRate(uint32_t baud)
+{
+    (void)baud;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef USART1_Write(const uint8_t *buf, uint32_t len)
+{
+    if (uart_sink != NULL)
+    {
+        (void)fwrite(buf, 1U, len, uart_sink);
+    }
+    return HAL_OK;
+}
+
+uint32_t USART1_TxDropped(void)
+{
+    return 0U;
+}
+
+void USART1_TxFlush(void)
+{
+    (void)fflush(stdout);
+    if (uart_sink != NULL)
+    {
+        (void)fflush(uart_sink);
+    }
+}
+
+bool USART1_ReadByte(uint8_t *ch)
+{
+    (void)ch;
+    return false;
+}
+
+/**
+ * @brief 设置 USART1_Write() 的输出文件
+ */
+void host_uart_set_sink(FILE *sink)
+{
+    uart_sink = sink;
+}
+
+/* ========== 舵机 ========== */
+
+HAL_StatusTypeDef Servo_SetAngle(uint8_t angle_deg)
+{
+    (void)angle_deg;
+    return HAL_OK;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file host_app.c
+ * @brief 主机程序公用的 DOA 启动流程
+ */
+#include "host_stub.h"
+#include "app_doa.h"
+
+/**
+ * @brief 初始化 DOA 系统并切换到与采样率匹配的档位
+ */
+int host_app_start(uint32_t fs_hz, int requested)
+{
+    int idx = -1;
+
+    if (app_doa_init() != HAL_OK)
+    {
+        fprintf(stderr, "app_doa_init failed\n");
+        return -1;
+    }
+
+    if (requested >= 0)
+    {
+        const app_doa_profile_t *p = app_doa_get_profile((uint32_t)requested);
+        idx = (p != NULL && p->fs_hz == fs_hz) ? requested : -1;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < app_doa_profile_count(); i++)
+        {
+            if (app_doa_get_profile(i)->fs_hz == fs_hz)
+            {
+                idx = (int)i;
+                break;
+            }
+        }
+    }
+
+    if (idx < 0)
+    {
+        fprintf(stderr, "no profile matches %lu Hz\n", (unsigned long)fs_hz);
+        return -1;
+    }
+
+    /* app_doa_init() 已按档位 0 启动 */
+    if (idx != 0 && app_doa_set_profile((uint32_t)idx) != HAL_OK)
+    {
+        fprintf(stderr, "app_doa_set_profile(%d) failed\n", idx);
+        return -1;
+    }
+
+    return idx;
+}
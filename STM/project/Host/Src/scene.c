@@ -0,0 +1,282 @@
+/**
+ * @file scene.c
+ * @brief 双麦克风声学场景合成实现
+ *
+ * 镜像源采用 Allen-Berkley 方法：每个坐标轴上镜像位置为 (1-2p)*s + 2*n*L，
+ * 反射次数为 |n-p| + |n|，三轴反射总数不超过 order 的镜像参与合成，
+ * 增益为 beta^反射次数，并按传播距离衰减（直达声增益约为 1）。
+ * 运动声源按 SCENE_BLOCK 个采样分段，段内视为静止，每段重算全部路径。
+ */
+#include "scene.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENE_PI 3.14159265358979f
+
+/* 分段长度（采样数） */
+#define SCENE_BLOCK 256U
+
+/* 分数延迟 sinc 半长，共 2*SCENE_FD_HALF 个抽头 */
+#define SCENE_FD_HALF 8
+
+/* 单个声源单个麦克风的最多路径数 */
+#define SCENE_PATHS_MAX 1024U
+
+/**
+ * @brief 一条传播路径：整数延迟 + 含增益的分数延迟抽头
+ */
+typedef struct
+{
+    uint32_t delay;
+    float taps[2 * SCENE_FD_HALF];
+} scene_path_t;
+
+/* xorshift32 状态 */
+static uint32_t rng_state = 1U;
+
+static float rng_uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return ((float)(rng_state >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Box-Muller 标准正态分布
+ */
+static float rng_gauss(void)
+{
+    float u1 = rng_uniform();
+    float u2 = rng_uniform();
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * SCENE_PI * u2);
+}
+
+/**
+ * @brief 填入默认场景
+ */
+void scene_defaults(scene_t *sc)
+{
+    memset(sc, 0, sizeof(*sc));
+    sc->fs_hz = FS_HZ;
+    sc->duration_s = 3.0f;
+    sc->snr_db = 20.0f;
+    sc->mic_dist_m = MIC_DIST_M;
+    sc->src_dist_m = 1.5f;
+    sc->room_m[0] = 6.0f;
+    sc->room_m[1] = 5.0f;
+    sc->room_m[2] = 3.0f;
+    sc->array_m[0] = 3.0f;
+    sc->array_m[1] = 1.5f;
+    sc->array_m[2] = 1.2f;
+    sc->beta = 0.0f;
+    sc->order = 2U;
+    sc->seed = 1U;
+}
+
+/**
+ * @brief 声源 k 在 t 时刻的角度
+ */
+float scene_source_theta(const scene_t *sc, uint32_t k, float t_s)
+{
+    const scene_source_t *s = &sc->src[k];
+    float a = t_s / sc->duration_s;
+
+    if (a < 0.0f)
+    {
+        a = 0.0f;
+    }
+    if (a > 1.0f)
+    {
+        a = 1.0f;
+    }
+    return s->theta0_deg + (s->theta1_deg - s->theta0_deg) * a;
+}
+
+/**
+ * @brief 加窗 sinc 分数延迟抽头：taps[j] 作用于 x[n - delay - (j - SCENE_FD_HALF + 1)]
+ */
+static void fd_taps(float mu, float gain, float *taps)
+{
+    for (int j = 0; j < 2 * SCENE_FD_HALF; j++)
+    {
+        float x = (float)(j - SCENE_FD_HALF + 1) - mu;
+        float s = (fabsf(x) < 1e-6f) ? 1.0f : sinf(SCENE_PI * x) / (SCENE_PI * x);
+        float w = 0.42f + 0.5f * cosf(SCENE_PI * x / SCENE_FD_HALF) +
+                  0.08f * cosf(2.0f * SCENE_PI * x / SCENE_FD_HALF);
+        taps[j] = gain * s * w;
+    }
+}
+
+/**
+ * @brief 计算声源到麦克风的全部路径
+ * @param src 声源位置
+ * @param mic 麦克风位置
+ * @param paths 输出路径
+ * @retval 路径数
+ */
+static uint32_t image_paths(const scene_t *sc, const float *src, const float *mic, scene_path_t *paths)
+{
+    int n_max = (sc->beta > 0.0f) ? (int)sc->order : 0;
+    float per_m = (float)sc->fs_hz / SOUND_SPEED;
+    uint32_t count = 0;
+
+    for (int px = 0; px <= (n_max ? 1 : 0); px++)
+    for (int py = 0; py <= (n_max ? 1 : 0); py++)
+    for (int pz = 0; pz <= (n_max ? 1 : 0); pz++)
+    for (int nx = -n_max; nx <= n_max; nx++)
+    for (int ny = -n_max; ny <= n_max; ny++)
+    for (int nz = -n_max; nz <= n_max; nz++)
+    {
+        int refl = abs(nx - px) + abs(nx) + abs(ny - py) + abs(ny) + abs(nz - pz) + abs(nz);
+        if (refl > n_max || count >= SCENE_PATHS_MAX)
+        {
+            continue;
+        }
+
+        float ix = (float)(1 - 2 * px) * src[0] + 2.0f * (float)nx * sc->room_m[0];
+        float iy = (float)(1 - 2 * py) * src[1] + 2.0f * (float)ny * sc->room_m[1];
+        float iz = (float)(1 - 2 * pz) * src[2] + 2.0f * (float)nz * sc->room_m[2];
+        float dx = ix - mic[0];
+        float dy = iy - mic[1];
+        float dz = iz - mic[2];
+        float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+        float delay = dist * per_m;
+        float gain = powf(sc->beta, (float)refl) * sc->src_dist_m / dist;
+
+        paths[count].delay = (uint32_t)delay;
+        fd_taps(delay - (float)paths[count].delay, gain, paths[count].taps);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief 合成整段录音
+ */
+uint16_t *scene_render(const scene_t *sc, uint32_t *pairs)
+{
+    uint32_t n = (uint32_t)(sc->duration_s * (float)sc->fs_hz);
+    float room_diag = sqrtf(sc->room_m[0] * sc->room_m[0] + sc->room_m[1] * sc->room_m[1] +
+                            sc->room_m[2] * sc->room_m[2]);
+    /* 最长路径不超过 (2*order+2) 倍房间对角线，源信号需要这么长的预卷 */
+    uint32_t pre = (uint32_t)((2.0f * (float)sc->order + 2.0f) * room_diag * (float)sc->fs_hz / SOUND_SPEED) +
+                   (uint32_t)SCENE_FD_HALF + 1U;
+    float *sig = NULL;
+    float *mix[2] = {NULL, NULL};
+    scene_path_t *paths = NULL;
+    uint16_t *out = NULL;
+
+    *pairs = 0;
+    if (n == 0U || sc->n_sources == 0U || sc->n_sources > SCENE_SOURCES_MAX)
+    {
+        return NULL;
+    }
+
+    sig = calloc((size_t)(pre + n + SCENE_FD_HALF), sizeof(float));
+    mix[0] = calloc(n, sizeof(float));
+    mix[1] = calloc(n, sizeof(float));
+    paths = malloc(SCENE_PATHS_MAX * sizeof(scene_path_t));
+    if (sig == NULL || mix[0] == NULL || mix[1] == NULL || paths == NULL)
+    {
+        goto done;
+    }
+
+    rng_state = sc->seed ? sc->seed : 1U;
+
+    for (uint32_t k = 0; k < sc->n_sources; k++)
+    {
+        float amp = powf(10.0f, sc->src[k].level_db / 20.0f);
+
+        for (uint32_t i = 0; i < pre + n + SCENE_FD_HALF; i++)
+        {
+            sig[i] = amp * rng_gauss();
+        }
+
+        for (uint32_t b = 0; b < n; b += SCENE_BLOCK)
+        {
+            uint32_t len = (n - b < SCENE_BLOCK) ? n - b : SCENE_BLOCK;
+            float th = scene_source_theta(sc, k, ((float)b + 0.5f * (float)len) / (float)sc->fs_hz) *
+                       (SCENE_PI / 180.0f);
+            float src[3] = {sc->array_m[0] + sc->src_dist_m * sinf(th),
+                            sc->array_m[1] + sc->src_dist_m * cosf(th),
+                            sc->array_m[2]};
+
+            for (uint32_t a = 0; a < 3U; a++)
+            {
+                if (src[a] <= 0.0f || src[a] >= sc->room_m[a])
+                {
+                    fprintf(stderr, "scene: source %lu outside the room\n", (unsigned long)k);
+                    goto done;
+                }
+            }
+
+            for (uint32_t m = 0; m < 2U; m++)
+            {
+                float sign = (m == 0U) ? -0.5f : 0.5f;
+                float mic[3] = {sc->array_m[0] + sign * sc->mic_dist_m, sc->array_m[1], sc->array_m[2]};
+                uint32_t n_paths = image_paths(sc, src, mic, paths);
+
+                for (uint32_t p = 0; p < n_paths; p++)
+                {
+                    /* x 的第 0 个输出采样位于 sig[pre] */
+                    const float *x = &sig[pre + b - paths[p].delay + SCENE_FD_HALF - 1];
+
+                    for (uint32_t i = 0; i < len; i++)
+                    {
+                        float acc = 0.0f;
+                        for (int j = 0; j < 2 * SCENE_FD_HALF; j++)
+                        {
+                            acc += paths[p].taps[j] * x[(int)i - j];
+                        }
+                        mix[m][b + i] += acc;
+                    }
+                }
+            }
+        }
+    }
+
+    /* 按干净信号功率叠加噪声，再归一化到半满量程 */
+    double power = 0.0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        power += (double)mix[0][i] * mix[0][i] + (double)mix[1][i] * mix[1][i];
+    }
+    float sigma = sqrtf((float)(power / (2.0 * n)) / powf(10.0f, sc->snr_db / 10.0f));
+    float peak = 0.0f;
+    for (uint32_t m = 0; m < 2U; m++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            mix[m][i] += sigma * rng_gauss();
+            if (fabsf(mix[m][i]) > peak)
+            {
+                peak = fabsf(mix[m][i]);
+            }
+        }
+    }
+
+    out = malloc((size_t)n * 2U * sizeof(uint16_t));
+    if (out == NULL)
+    {
+        goto done;
+    }
+    float scale = (peak > 0.0f) ? 16383.0f / peak : 0.0f;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        /* 有符号值转 ADC 偏移码 */
+        out[2U * i] = (uint16_t)((int32_t)lrintf(mix[0][i] * scale) + 32768);
+        out[2U * i + 1U] = (uint16_t)((int32_t)lrintf(mix[1][i] * scale) + 32768);
+    }
+    *pairs = n;
+
+done:
+    free(sig);
+    free(mix[0]);
+    free(mix[1]);
+    free(paths);
+    return out;
+}
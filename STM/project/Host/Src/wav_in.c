@@ -0,0 +1,90 @@
+/**
+ * @file wav_in.c
+ * @brief 双声道 16 位 PCM WAV 读取
+ */
+#include "wav_in.h"
+#include <stdbool.h>
+#include <string.h>
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 打开 WAV 并定位到 data 块
+ */
+int wav_open(wav_in_t *w, const char *path)
+{
+    uint8_t hdr[12];
+    uint8_t ck[8];
+    bool have_fmt = false;
+
+    w->f = fopen(path, "rb");
+    if (w->f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    if (fread(hdr, 1, sizeof(hdr), w->f) != sizeof(hdr) ||
+        memcmp(hdr, "RIFF", 4) != 0 || memcmp(&hdr[8], "WAVE", 4) != 0)
+    {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+        return -1;
+    }
+
+    while (fread(ck, 1, sizeof(ck), w->f) == sizeof(ck))
+    {
+        uint32_t size = rd32(&ck[4]);
+
+        if (memcmp(ck, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[40];
+            uint32_t n = (size < sizeof(fmt)) ? size : (uint32_t)sizeof(fmt);
+            uint16_t tag;
+
+            if (size < 16U || fread(fmt, 1, n, w->f) != n)
+            {
+                break;
+            }
+            tag = rd16(&fmt[0]);
+            if (tag == 0xFFFEU && n >= 26U)
+            {
+                tag = rd16(&fmt[24]); /* 扩展格式的子格式 GUID 前两字节 */
+            }
+            if (tag != 1U || rd16(&fmt[2]) != 2U || rd16(&fmt[14]) != 16U)
+            {
+                fprintf(stderr, "%s: need 2-channel 16-bit PCM (format %u, %u ch, %u bit)\n",
+                        path, tag, rd16(&fmt[2]), rd16(&fmt[14]));
+                return -1;
+            }
+            w->fs_hz = rd32(&fmt[4]);
+            have_fmt = true;
+            size -= n;
+        }
+        else if (memcmp(ck, "data", 4) == 0)
+        {
+            if (!have_fmt)
+            {
+                break;
+            }
+            w->pairs = size / 4U;
+            return 0;
+        }
+
+        /* 跳过其余字节，块长度为奇数时有 1 字节填充 */
+        if (fseek(w->f, (long)(size + (size & 1U)), SEEK_CUR) != 0)
+        {
+            break;
+        }
+    }
+
+    fprintf(stderr, "%s: missing fmt or data chunk\n", path);
+    return -1;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file doa_qemu.c
+ * @brief QEMU mps2-an500 上的 DOA 流水线驱动程序
+ *
+ * 经半主机读取主机上的双声道 16 位 WAV，按 hop 灌入模拟 ADC DMA，走与固件相同的
+ * audio_frame -> frame_window -> gcc_phat -> app_doa 路径，代码按 Cortex-M7
+ * （fpv5-d16 硬浮点、DSP 扩展）生成。输出每次估计的结果与指令数，
+ * 可与 doa_host 的 CSV 逐帧对比，检查 ARM 代码生成与数值一致性。
+ *
+ * 用法（参数经 -semihosting-config arg=... 传入，见 Qemu/CMakeLists.txt）:
+ *     doa_qemu [-p 档位] [-c out.csv] input.wav
+ *     doa_qemu -b                 运行 dsp_bench 基准测试
+ */
+#include "host_stub.h"
+#include "wav_in.h"
+#include "app_doa.h"
+#include "frame_window.h"
+#include "deadline.h"
+#include "dsp_bench.h"
+#include "profile.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* 每次读取的采样对数 */
+#define QEMU_BLOCK_PAIRS 256U
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-p profile] [-c out.csv] input.wav\n"
+            "       %s -b    run the dsp_bench kernels\n",
+            prog, prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *prog = (argc > 0) ? argv[0] : "doa_qemu";
+    const char *csv_path = NULL;
+    int requested = -1;
+    bool bench = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:c:bh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            requested = atoi(optarg);
+            break;
+        case 'c':
+            csv_path = optarg;
+            break;
+        case 'b':
+            bench = true;
+            break;
+        default:
+            usage(prog);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (bench)
+    {
+        return (dsp_bench_run() == HAL_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (optind != argc - 1)
+    {
+        usage(prog);
+        return EXIT_FAILURE;
+    }
+
+    wav_in_t wav = {0};
+    if (wav_open(&wav, argv[optind]) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL && (csv = fopen(csv_path, "w")) == NULL)
+    {
+        perror(csv_path);
+        return EXIT_FAILURE;
+    }
+    host_uart_set_sink(NULL);
+
+    int idx = host_app_start(wav.fs_hz, requested);
+    if (idx < 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    const app_doa_profile_t *prof = app_doa_get_profile((uint32_t)idx);
+    uint32_t hop = prof->frame_n / FRAME_HOP_DIV;
+
+    printf("input: %s fs=%lu Hz, %lu pairs\n", argv[optind], (unsigned long)wav.fs_hz,
+           (unsigned long)wav.pairs);
+    printf("profile %d: frame=%lu hop=%lu fft=%lu\n", idx, (unsigned long)prof->frame_n,
+           (unsigned long)hop, (unsigned long)prof->fft_l);
+
+    if (csv != NULL)
+    {
+        fprintf(csv, "seq,valid,lag_sub,theta_deg,peak,ratio,theta_smooth,insn\n");
+    }
+
+    static int16_t block[2U * QEMU_BLOCK_PAIRS];
+    uint32_t left = wav.pairs;
+    uint32_t n_hops = 0;
+    uint32_t n_est = 0;
+    uint32_t n_valid = 0;
+    uint64_t insn_sum = 0;
+    uint32_t insn_max = 0;
+
+    while (left > 0U)
+    {
+        uint32_t n = (left < QEMU_BLOCK_PAIRS) ? left : QEMU_BLOCK_PAIRS;
+
+        n = (uint32_t)fread(block, 4U, n, wav.f);
+        if (n == 0U)
+        {
+            break; /* data 块长度超出文件实际长度 */
+        }
+        left -= n;
+        (void)host_adc_feed(block, n);
+
+        while (app_doa_frame_ready())
+        {
+            gcc_phat_result_t r;
+            float smooth;
+            uint32_t t0 = DWT->CYCCNT;
+
+            app_doa_process_frame();
+            app_doa_servo_update();
+
+            uint32_t insn = DWT->CYCCNT - t0;
+            insn_sum += insn;
+            if (insn > insn_max)
+            {
+                insn_max = insn;
+            }
+            n_hops++;
+
+            if (!app_doa_get_result(&r, &smooth))
+            {
+                continue; /* 分析窗尚未填满 */
+            }
+
+            n_est++;
+            n_valid += r.valid ? 1U : 0U;
+            if (csv != NULL)
+            {
+                fprintf(csv, "%lu,%d,%.4f,%.3f,%.4f,%.3f,%.3f,%lu\n",
+                        (unsigned long)frame_window_seq(), r.valid ? 1 : 0, (double)r.lag_sub,
+                        (double)r.theta_deg, (double)r.peak, (double)r.ratio, (double)smooth,
+                        (unsigned long)insn);
+            }
+        }
+    }
+
+    deadline_stats_t dl;
+    deadline_get_stats(&dl);
+
+    printf("estimates: %lu valid: %lu\n", (unsigned long)n_est, (unsigned long)n_valid);
+    printf("insn per hop: mean %lu, max %lu (hop budget %lu cycles @ %lu MHz, load ~%lu%%)\n",
+           (unsigned long)(n_hops ? insn_sum / n_hops : 0U), (unsigned long)insn_max,
+           (unsigned long)((uint64_t)SystemCoreClock * hop / wav.fs_hz),
+           (unsigned long)(SystemCoreClock / 1000000U), (unsigned long)dl.load_pct);
+
+#if PROFILE_ENABLE
+    profile_dump();
+#endif
+
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+    fclose(wav.f);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file qemu_clock.c
+ * @brief QEMU 构建的 DWT 周期计数器
+ *
+ * QEMU 不模拟 DWT，这里用 SysTick 代替：处理器时钟源下 SysTick 按 mps2 的
+ * 25 MHz SYSCLK 递减，计满 24 位时中断扩展到 32 位。以 -icount shift=0 运行时
+ * 每条指令推进 1 ns 虚拟时间，因此 CYCCNT = 计数 * 40 即为执行的指令数
+ * （粒度 40 条）。Cortex-M7 双发射，指令数只是周期数的近似，
+ * 适合做版本间的相对比较；不加 -icount 时计数跟随主机时间，没有意义。
+ */
+#include "main.h"
+
+/* mps2 的 SYSCLK，即 SysTick 处理器时钟源频率 */
+#define QEMU_SYSCLK_HZ 25000000U
+
+/* -icount shift=0 下每个 SysTick 计数对应的指令数 */
+#define QEMU_INSN_PER_TICK (1000000000U / QEMU_SYSCLK_HZ)
+
+/* SysTick 寄存器 */
+#define SYST_CSR (*(volatile uint32_t *)0xE000E010UL)
+#define SYST_RVR (*(volatile uint32_t *)0xE000E014UL)
+#define SYST_CVR (*(volatile uint32_t *)0xE000E018UL)
+
+#define SYST_CSR_ENABLE (1UL << 0)
+#define SYST_CSR_TICKINT (1UL << 1)
+#define SYST_CSR_CLKSOURCE (1UL << 2)
+
+#define SYST_RELOAD 0x00FFFFFFUL
+
+static DWT_Type host_dwt_regs;
+static volatile uint32_t systick_wraps = 0;
+
+void qemu_clock_init(void);
+void SysTick_Handler(void);
+
+/**
+ * @brief 启动 SysTick 自由计数
+ */
+void qemu_clock_init(void)
+{
+    SYST_RVR = SYST_RELOAD;
+    SYST_CVR = 0U;
+    SYST_CSR = SYST_CSR_CLKSOURCE | SYST_CSR_TICKINT | SYST_CSR_ENABLE;
+}
+
+void SysTick_Handler(void)
+{
+    systick_wraps++;
+}
+
+/**
+ * @brief 刷新 CYCCNT 后返回 DWT 替身
+ */
+DWT_Type *host_dwt(void)
+{
+    uint32_t hi;
+    uint32_t val;
+
+    /* 读取期间发生回绕则重读 */
+    do
+    {
+        hi = systick_wraps;
+        val = SYST_CVR;
+    } while (hi != systick_wraps);
+
+    uint32_t ticks = (hi << 24) + (SYST_RELOAD - val);
+    host_dwt_regs.CYCCNT = ticks * QEMU_INSN_PER_TICK;
+
+    return &host_dwt_regs;
+}
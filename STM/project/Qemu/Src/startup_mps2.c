@@ -0,0 +1,137 @@
+/**
+ * @file startup_mps2.c
+ * @brief QEMU mps2-an500 启动代码与半主机命令行
+ *
+ * 不使用 newlib 的 crt0：其中的 SYS_HEAPINFO 在各 QEMU 版本的 M 核板上返回值不一，
+ * 这里按链接脚本自行确定栈与堆。复位后打开 FPU、清零 .bss、初始化 librdimon 的
+ * 半主机文件句柄，再从 SYS_GET_CMDLINE 取得参数调用 main()，返回值经 exit() 交给 QEMU。
+ * .data 由 QEMU 加载 ELF 时直接写入 RAM，无需复制。
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 半主机操作号 */
+#define SEMIHOST_SYS_GET_CMDLINE 0x15U
+#define SEMIHOST_SYS_EXIT 0x18U
+
+/* SYS_EXIT 原因码：运行时错误，QEMU 以非零状态退出 */
+#define SEMIHOST_ADP_RUNTIME_ERROR 0x20023U
+
+/* 命令行缓冲区与最多参数个数 */
+#define CMDLINE_SIZE 256U
+#define ARGV_MAX 16U
+
+/* 系统控制块中的 CPACR */
+#define SCB_CPACR (*(volatile uint32_t *)0xE000ED88UL)
+
+extern uint32_t __stack;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+extern int main(int argc, char **argv);
+extern void initialise_monitor_handles(void);
+extern void qemu_clock_init(void);
+
+void Reset_Handler(void);
+void Fault_Handler(void);
+void SysTick_Handler(void);
+
+static char cmdline[CMDLINE_SIZE];
+static char *argv_buf[ARGV_MAX + 1U];
+
+/**
+ * @brief 半主机调用
+ */
+static uint32_t semihost_call(uint32_t op, const void *arg)
+{
+    register uint32_t r0 __asm("r0") = op;
+    register const void *r1 __asm("r1") = arg;
+
+    __asm volatile("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+/**
+ * @brief 读取 QEMU -semihosting-config arg=... 给出的命令行并按空格切分
+ * @retval argc，读取失败时为 0
+ */
+static int semihost_args(void)
+{
+    struct
+    {
+        char *buf;
+        uint32_t len;
+    } blk = {cmdline, CMDLINE_SIZE};
+    int argc = 0;
+
+    if (semihost_call(SEMIHOST_SYS_GET_CMDLINE, &blk) != 0U)
+    {
+        return 0;
+    }
+
+    for (char *p = cmdline; *p != '\0' && (uint32_t)argc < ARGV_MAX;)
+    {
+        while (*p == ' ')
+        {
+            *p++ = '\0';
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+        argv_buf[argc++] = p;
+        while (*p != '\0' && *p != ' ')
+        {
+            p++;
+        }
+    }
+    argv_buf[argc] = NULL;
+
+    return argc;
+}
+
+void Reset_Handler(void)
+{
+    /* CP10/CP11 全访问，之后才能执行浮点指令 */
+    SCB_CPACR |= (0xFUL << 20);
+    __asm volatile("dsb\n\tisb" ::: "memory");
+
+    memset(&__bss_start__, 0, (size_t)((uint8_t *)&__bss_end__ - (uint8_t *)&__bss_start__));
+
+    initialise_monitor_handles();
+    qemu_clock_init();
+
+    int argc = semihost_args();
+    exit(main(argc, argv_buf));
+}
+
+/**
+ * @brief 所有异常的默认处理：直接结束仿真，避免卡死在死循环里
+ */
+void Fault_Handler(void)
+{
+    (void)semihost_call(SEMIHOST_SYS_EXIT, (const void *)SEMIHOST_ADP_RUNTIME_ERROR);
+    for (;;)
+    {
+    }
+}
+
+__attribute__((section(".isr_vector"), used)) static const uintptr_t vector_table[16] = {
+    (uintptr_t)&__stack,
+    (uintptr_t)Reset_Handler,
+    (uintptr_t)Fault_Handler, /* NMI */
+    (uintptr_t)Fault_Handler, /* HardFault */
+    (uintptr_t)Fault_Handler, /* MemManage */
+    (uintptr_t)Fault_Handler, /* BusFault */
+    (uintptr_t)Fault_Handler, /* UsageFault */
+    0U,
+    0U,
+    0U,
+    0U,
+    (uintptr_t)Fault_Handler, /* SVCall */
+    (uintptr_t)Fault_Handler, /* DebugMon */
+    0U,
+    (uintptr_t)Fault_Handler, /* PendSV */
+    (uintptr_t)SysTick_Handler,
+};
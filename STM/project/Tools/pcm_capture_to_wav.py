@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+原始 PCM 采集流转 WAV
+
+解析 PCM_CAPTURE_ENABLE 模式下 USART1 输出的二进制流（格式见
+Core/Inc/pcm_capture.h），按帧头序号拼接为双声道 16 位 WAV。
+丢失的帧默认以静音补齐，保持时间轴与采集端一致。
+
+串口数据可先落盘再转换，例如 (Linux):
+    stty -F /dev/ttyUSB0 4000000 raw -echo
+    cat /dev/ttyUSB0 > capture.bin
+
+用法:
+    python3 pcm_capture_to_wav.py capture.bin out.wav [--no-fill]
+"""
+import argparse
+import struct
+import sys
+import wave
+
+MAGIC = b"PCMF"
+HEADER = struct.Struct("<4sBBHIII")  # magic, version, channels, frame_n, seq, tick_ms, fs_hz
+VERSION = 1
+
+
+def parse_frames(data):
+    """逐帧产出 (seq, tick_ms, fs_hz, frame_n, payload)，遇到损坏数据时重新对齐帧头"""
+    pos = 0
+    skipped = 0
+    while True:
+        idx = data.find(MAGIC, pos)
+        if idx < 0:
+            skipped += len(data) - pos
+            break
+        skipped += idx - pos
+        if idx + HEADER.size > len(data):
+            break
+        magic, version, channels, frame_n, seq, tick_ms, fs_hz = HEADER.unpack_from(data, idx)
+        end = idx + HEADER.size + frame_n * channels * 2
+        if version != VERSION or channels != 2 or frame_n == 0 or end > len(data):
+            pos = idx + 1
+            continue
+        # 下一帧帧头应紧随其后，否则视为误同步
+        if end + len(MAGIC) <= len(data) and data[end:end + len(MAGIC)] != MAGIC:
+            pos = idx + 1
+            continue
+        yield seq, tick_ms, fs_hz, frame_n, data[idx + HEADER.size:end]
+        pos = end
+    if skipped:
+        print(f"skipped {skipped} bytes outside frames", file=sys.stderr)
+
+
+def to_signed(payload):
+    """ADC 偏移码 -> 有符号 16 位（与 audio_frame_to_float 的异或 0x8000 一致）"""
+    n = len(payload) // 2
+    codes = struct.unpack(f"<{n}H", payload)
+    return struct.pack(f"<{n}h", *[c - 32768 for c in codes])
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a raw USART1 PCM capture stream to WAV")
+    ap.add_argument("input", help="captured byte stream ('-' for stdin)")
+    ap.add_argument("output", help="output WAV file")
+    ap.add_argument("--no-fill", action="store_true", help="do not insert silence for dropped frames")
+    args = ap.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as f:
+            data = f.read()
+
+    out = None
+    fs = None
+    frames = 0
+    lost = 0
+    last_seq = None
+
+    for seq, tick_ms, fs_hz, frame_n, payload in parse_frames(data):
+        if out is None:
+            fs = fs_hz
+            out = wave.open(args.output, "wb")
+            out.setnchannels(2)
+            out.setsampwidth(2)
+            out.setframerate(fs)
+            first_tick = tick_ms
+        elif fs_hz != fs:
+            print(f"sample rate changed {fs} -> {fs_hz} at seq {seq}, stopping", file=sys.stderr)
+            break
+
+        if last_seq is not None:
+            gap = (seq - last_seq - 1) & 0xFFFFFFFF
+            if gap:
+                lost += gap
+                if not args.no_fill:
+                    out.writeframes(bytes(gap * frame_n * 4))
+        last_seq = seq
+
+        out.writeframes(to_signed(payload))
+        frames += 1
+
+    if out is None:
+        sys.exit("no frames found")
+    out.close()
+
+    print(f"{frames} frames, {lost} lost ({100.0 * lost / (frames + lost):.2f}%), "
+          f"fs={fs} Hz, span {(tick_ms - first_tick) / 1000.0:.2f} s -> {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+DOA 二进制遥测解码
+
+解析 TELEMETRY_ENABLE 模式下 USART1 输出的 COBS 帧（格式见
+Core/Inc/telemetry.h），校验 CRC16 后输出 CSV 或汇总统计。
+
+串口数据可先落盘再解码，例如 (Linux):
+    stty -F /dev/ttyUSB0 921600 raw -echo
+    cat /dev/ttyUSB0 > telemetry.bin
+
+用法:
+    python3 telemetry_decode.py telemetry.bin [--csv out.csv] [--cpu-hz 240000000]
+"""
+import argparse
+import binascii
+import csv
+import struct
+import sys
+
+VERSION = 1
+RECORD = struct.Struct("<BBI6fII")
+FIELDS = ("seq", "valid", "lag_sub", "dt", "theta_deg", "peak", "ratio",
+          "theta_smooth", "cycles_gcc", "cycles_total")
+
+
+def cobs_decode(frame):
+    """COBS 解码，格式错误时返回 None"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        end = i + code
+        if code == 0 or end > len(frame):
+            return None
+        out += frame[i + 1:end]
+        i = end
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_stream(data):
+    """逐条产出解码后的记录字典，同时统计错误数"""
+    stats = {"frames": 0, "bad_cobs": 0, "bad_len": 0, "bad_crc": 0, "bad_version": 0, "text": 0}
+    for frame in data.split(b"\x00"):
+        if not frame:
+            continue
+        # PROFILE_ENABLE 时 profile_dump() 输出的文本段，以 0x00 结尾自成一帧
+        if b"[prof]" in frame:
+            stats["text"] += 1
+            sys.stderr.write(frame[frame.index(b"[prof]"):].decode("ascii", "replace"))
+            continue
+        raw = cobs_decode(frame)
+        if raw is None:
+            stats["bad_cobs"] += 1
+            continue
+        if len(raw) != RECORD.size + 2:
+            stats["bad_len"] += 1
+            continue
+        body, crc = raw[:-2], struct.unpack("<H", raw[-2:])[0]
+        # CRC-16/CCITT-FALSE，与 telemetry_crc16() 一致
+        if binascii.crc_hqx(body, 0xFFFF) != crc:
+            stats["bad_crc"] += 1
+            continue
+        version, flags, seq, lag, dt, theta, peak, ratio, smooth, cyc_gcc, cyc_total = RECORD.unpack(body)
+        if version != VERSION:
+            stats["bad_version"] += 1
+            continue
+        stats["frames"] += 1
+        yield stats, dict(zip(FIELDS, (seq, flags & 1, lag, dt, theta, peak, ratio,
+                                       smooth, cyc_gcc, cyc_total)))
+    yield stats, None
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode DOA binary telemetry frames")
+    ap.add_argument("input", help="captured byte stream ('-' for stdin)")
+    ap.add_argument("--csv", help="write decoded records to this CSV file")
+    ap.add_argument("--cpu-hz", type=float, default=240e6, help="core clock for cycle -> us conversion")
+    args = ap.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as f:
+            data = f.read()
+
+    writer = None
+    if args.csv:
+        csv_file = open(args.csv, "w", newline="")
+        writer = csv.DictWriter(csv_file, fieldnames=FIELDS)
+        writer.writeheader()
+
+    stats = None
+    n_valid = 0
+    gaps = 0
+    last_seq = None
+    cyc_gcc = []
+    cyc_total = []
+
+    for stats, rec in decode_stream(data):
+        if rec is None:
+            break
+        if writer:
+            writer.writerow(rec)
+        if last_seq is not None and rec["seq"] != last_seq + 1:
+            gaps += 1
+        last_seq = rec["seq"]
+        n_valid += rec["valid"]
+        cyc_gcc.append(rec["cycles_gcc"])
+        cyc_total.append(rec["cycles_total"])
+
+    if writer:
+        csv_file.close()
+
+    n = stats["frames"]
+    print(f"records:{n} valid:{n_valid} seq_gaps:{gaps} "
+          f"bad_cobs:{stats['bad_cobs']} bad_len:{stats['bad_len']} "
+          f"bad_crc:{stats['bad_crc']} bad_version:{stats['bad_version']} "
+          f"text:{stats['text']}")
+    if n:
+        us = 1e6 / args.cpu_hz
+        print(f"gcc_phat cycles  mean:{sum(cyc_gcc) / n:.0f} max:{max(cyc_gcc)} "
+              f"({max(cyc_gcc) * us:.1f} us)")
+        print(f"total cycles     mean:{sum(cyc_total) / n:.0f} max:{max(cyc_total)} "
+              f"({max(cyc_total) * us:.1f} us)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,34 @@
+# Source lists shared by the off-target builds (Host/ and Qemu/)
+
+# CMSIS-DSP sources used by gcc_phat.c
+set(DOA_CMSIS_DSP_Src
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/TransformFunctions/arm_cfft_f32.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/TransformFunctions/arm_cfft_radix8_f32.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/TransformFunctions/arm_bitreversal2.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/TransformFunctions/arm_rfft_fast_f32.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/TransformFunctions/arm_rfft_fast_init_f32.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/CommonTables/arm_common_tables.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/CommonTables/arm_const_structs.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/FastMathFunctions/arm_sin_f32.c
+    ${CMAKE_SOURCE_DIR}/Drivers/CMSIS/DSP/Source/FastMathFunctions/arm_cos_f32.c
+)
+
+# Firmware modules shared with the board build
+set(DOA_Application_Src
+    ${CMAKE_SOURCE_DIR}/Core/Src/audio_frame.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/frame_window.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/deadline.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/telemetry.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/profile.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/gcc_phat.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/servo_ctrl.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/app_doa.c
+    ${CMAKE_SOURCE_DIR}/Core/Src/dsp_bench.c
+)
+
+# HAL/peripheral stubs and helpers from Host/ that both builds link
+set(DOA_Stub_Src
+    ${CMAKE_SOURCE_DIR}/Host/Src/hal_stub.c
+    ${CMAKE_SOURCE_DIR}/Host/Src/host_app.c
+    ${CMAKE_SOURCE_DIR}/Host/Src/wav_in.c
+)